@@ -1,79 +1,165 @@
+// 用法: LL1 [--stats] [-g 文法文件] [输入串...]
+// --stats 以JSON格式输出各阶段的耗时、峰值内存和计数, 不打印分析过程
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
-char beginSymbol; // 文法开始符
+#include "../lexAnalyzer/lexer.h"
+#include "allocStats.h"
+#include "compressedTable.h"
+#include "grammar.h"
+#include "parseTree.h"
+#include "parser.h"
+#include "tinyCompiler.h"
 
-// 初始化文法
-void init(std::unordered_map<char, std::vector<std::string>> &grammar) {
-  grammar.insert(std::make_pair('E', std::vector<std::string>{"E+T", "T"}));
-  grammar.insert(std::make_pair('T', std::vector<std::string>{"T*F", "F"}));
-  grammar.insert(std::make_pair('F', std::vector<std::string>{"(E)", "i"}));
-  beginSymbol = 'E';
+// 一个阶段的耗时和峰值内存
+struct PhaseStats {
+  std::string name;
+  double wallMs;    // 耗时(毫秒)
+  size_t peakBytes; // 阶段内已分配字节数超出阶段开始时的峰值
+};
+
+// 执行f并统计耗时和峰值内存
+template <typename F> PhaseStats measurePhase(const std::string &name, F &&f) {
+  size_t base = allocatedBytes();
+  resetAllocPeak();
+  auto begin = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - begin;
+  return {name, elapsed.count(), allocPeakBytes() - base};
 }
 
-// 获取非终结符和终结符
-std::pair<std::set<char>, std::set<char>>
-getSymbols(const std::unordered_map<char, std::vector<std::string>> &grammar) {
-  std::set<char> nonterminals;
-  std::set<char> terminals;
-  // 获取非终结符集合
-  for (const auto &[non, exp] : grammar) {
-    nonterminals.insert(non);
-  }
-  // 获取终结符集合
-  for (const auto &[Non, exp] : grammar) {
-    for (const auto &str : exp) {
-      for (const auto &ch : str) {
-        // 如果在非终结符集合中没有找到
-        if (nonterminals.find(ch) == nonterminals.end()) {
-          if (ch != ' ')
-            terminals.insert(ch);
-        }
-      }
+// 转义JSON字符串
+std::string jsonString(const std::string &str) {
+  std::string res{"\""};
+  for (char ch : str) {
+    if (ch == '"' || ch == '\\') {
+      res += '\\';
+      res += ch;
+    } else if (static_cast<unsigned char>(ch) < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\u%04x", ch);
+      res += buf;
+    } else {
+      res += ch;
     }
   }
-  return std::make_pair(nonterminals, terminals);
+  return res + "\"";
 }
 
-// 消除左递归
-void eliLeftRecursion(
-    std::unordered_map<char, std::vector<std::string>> &grammar) {
-  std::unordered_map<char, std::vector<std::string>> newGrammar;
-  for (auto &[non, exp] : grammar) {
-    std::vector<std::string> alpha; // 直接左递归部分
-    std::vector<std::string> beta;  // 其他部分
-    for (const auto &prod : exp) {
-      if (prod[0] == non) { // 直接左递归
-        alpha.push_back(prod.substr(1));
-      } else {
-        beta.push_back(prod);
-      }
-    }
-    if (!alpha.empty()) {     // 存在左递归
-      char newNon = non + 26; // 新的非终结符
-      for (auto &b : beta) {
-        b += newNon;
-      }
-      std::vector<std::string> newExp;
-      for (auto &a : alpha) {
-        newExp.push_back(a + newNon);
-      }
-      newExp.push_back(" "); // 空串
-      // 构建新的语法表
-      newGrammar[non] = beta;
-      newGrammar[newNon] = newExp;
-    } else {
-      newGrammar[non] = exp;
+// 统计各阶段的耗时、峰值内存和计数, 以JSON格式输出
+void printStats(std::unordered_map<char, std::vector<std::string>> grammar,
+                char start, const std::vector<std::string> &inputs) {
+  std::vector<PhaseStats> phases;
+  std::set<char> nonterminals, terminals;
+  std::map<std::string, std::vector<char>> firstSet;
+  std::map<char, std::vector<char>> followSet;
+  std::map<char, std::map<char, std::string>> list;
+  CompressedTable table;
+  size_t expanded = 0, iterations = 0;
+  phases.push_back(measurePhase("eliLeftRecursion",
+                                [&]() { eliLeftRecursion(grammar); }));
+  phases.push_back(measurePhase("getSymbols", [&]() {
+    std::tie(nonterminals, terminals) = getSymbols(grammar);
+  }));
+  phases.push_back(measurePhase("getFirstSet", [&]() {
+    firstSet = getFirstSet(nonterminals, terminals, grammar, &expanded);
+  }));
+  phases.push_back(measurePhase("getFollowSet", [&]() {
+    followSet = getFollowSet(nonterminals, terminals, grammar, firstSet, start,
+                             &iterations);
+  }));
+  phases.push_back(measurePhase("LL1", [&]() {
+    list = LL1(firstSet, followSet, terminals, grammar);
+  }));
+  phases.push_back(measurePhase(
+      "CompressedTable", [&]() { table = CompressedTable(list, start); }));
+
+  // 逐个分析输入串, 合计为LL1Analyze阶段
+  struct InputStats {
+    bool accepted;
+    size_t symbols;
+    size_t steps;
+    PhaseStats phase;
+  };
+  std::vector<InputStats> results;
+  results.reserve(inputs.size());
+  PhaseStats analyze{"LL1Analyze", 0, 0};
+  ParseBuffers buffers;
+  for (const auto &input : inputs) {
+    bool accepted = false;
+    auto phase = measurePhase("LL1Analyze", [&]() {
+      accepted = LL1Analyze(table, input, nullptr, nullptr, &buffers);
+    });
+    analyze.wallMs += phase.wallMs;
+    analyze.peakBytes = std::max(analyze.peakBytes, phase.peakBytes);
+    results.push_back({accepted, buffers.symbols, buffers.steps, phase});
+  }
+  phases.push_back(analyze);
+
+  size_t productions = 0;
+  for (const auto &[non, exps] : grammar)
+    productions += exps.size();
+  size_t cells = 0, filled = 0;
+  for (const auto &[non, line] : list) {
+    for (const auto &[ter, exp] : line) {
+      cells++;
+      if (exp != "NULL")
+        filled++;
     }
   }
-  grammar = newGrammar;
+  auto report = table.getReport();
+
+  std::cout << std::fixed << std::setprecision(4);
+  std::cout << "{\n";
+  std::cout << "  \"grammar\": {\"nonterminals\": " << nonterminals.size()
+            << ", \"terminals\": " << terminals.size()
+            << ", \"productions\": " << productions << "},\n";
+  std::cout << "  \"phases\": [\n";
+  for (size_t i = 0; i < phases.size(); i++) {
+    std::cout << "    {\"name\": " << jsonString(phases[i].name)
+              << ", \"wallMs\": " << phases[i].wallMs
+              << ", \"peakBytes\": " << phases[i].peakBytes << "}"
+              << (i + 1 < phases.size() ? "," : "") << "\n";
+  }
+  std::cout << "  ],\n";
+  std::cout << "  \"getFirstSet\": {\"sententialForms\": " << expanded
+            << "},\n";
+  std::cout << "  \"getFollowSet\": {\"iterations\": " << iterations
+            << "},\n";
+  std::cout << "  \"table\": {\"cells\": " << cells
+            << ", \"filled\": " << filled << ", \"fillRatio\": "
+            << (cells ? static_cast<double>(filled) / cells : 0.0)
+            << ", \"denseBytes\": " << report.denseBytes
+            << ", \"packedBytes\": " << report.packedBytes
+            << ", \"compressionRatio\": " << report.ratio << "},\n";
+  std::cout << "  \"inputs\": [\n";
+  for (size_t i = 0; i < inputs.size(); i++) {
+    const auto &res = results[i];
+    std::cout << "    {\"input\": " << jsonString(inputs[i])
+              << ", \"accepted\": " << (res.accepted ? "true" : "false")
+              << ", \"symbols\": " << res.symbols
+              << ", \"steps\": " << res.steps << ", \"stepsPerSymbol\": "
+              << (res.symbols ? static_cast<double>(res.steps) / res.symbols
+                              : 0.0)
+              << ", \"wallMs\": " << res.phase.wallMs
+              << ", \"peakBytes\": " << res.phase.peakBytes << "}"
+              << (i + 1 < inputs.size() ? "," : "") << "\n";
+  }
+  std::cout << "  ]\n";
+  std::cout << "}" << std::endl;
 }
 
 // 打印语法消息
@@ -116,176 +202,6 @@ void printFollowSetInfo(std::map<char, std::vector<char>> &set) {
   }
 }
 
-bool isNotRepeated(char ch, std::string str,
-                   std::map<std::string, std::vector<char>> &firstSet) {
-  return std::find(firstSet[str].begin(), firstSet[str].end(), ch) ==
-         firstSet[str].end();
-}
-
-// 获取first集
-std::map<std::string, std::vector<char>>
-getFirstSet(const std::set<char> &nonterminals, const std::set<char> &terminals,
-            const std::unordered_map<char, std::vector<std::string>> &grammar) {
-  std::map<std::string, std::vector<char>> firstSet;
-  // 求每个产生部右侧的first集
-  for (auto [non, exps] : grammar) {
-    for (size_t i = 0; i < exps.size(); i++) {
-      auto exp = exps[i];
-      std::vector<std::string> tempExps{exp};
-      for (size_t j = 0; j < tempExps.size(); j++) {
-        auto tmp = tempExps[j];
-        // 如果第一个字符是空字符且长度不等于1则删除该字符
-        if (tmp[0] == ' ' && tmp.size() != 1)
-          tmp.erase(0, 1);
-        if (tmp[0] == ' ' && tmp.size() == 1) {
-          if (isNotRepeated(' ', exp, firstSet))
-            firstSet[exp].push_back(' ');
-        }
-        // 如果表达式的首个符号是终结符
-        else if (terminals.find(tmp[0]) != terminals.end()) {
-          if (isNotRepeated(tmp[0], exp, firstSet))
-            firstSet[exp].push_back(tmp[0]); // 将符号加入first集
-        } else {
-          auto alpha = tmp.substr(1); // 除去第一个符号的表达式
-          auto nextExps = grammar.at(tmp[0]); // 由第一个符号产生的表达式
-          for (auto prod : nextExps) {
-            tempExps.push_back(prod + alpha);
-          }
-        }
-      }
-    }
-  }
-  // 求每个非终结符的first集
-  for (auto non : nonterminals) {
-    std::string nonstr{non};
-    auto exps = grammar.at(non);
-    for (auto exp : exps) {
-      // 将每个产生式右部的first集加入对应的非终结符的first集
-      for (auto ch : firstSet[exp]) {
-        if (isNotRepeated(ch, nonstr, firstSet))
-          firstSet[nonstr].push_back(ch);
-      }
-    }
-  }
-  return firstSet;
-}
-
-// 合并向量去重
-void mergeAndDeduplicate(std::vector<char> &dest,
-                         const std::vector<char> &src) {
-  for (char c : src) {
-    if (std::find(dest.begin(), dest.end(), c) == dest.end()) {
-      dest.push_back(c);
-    }
-  }
-}
-
-bool isNotRepeated(char ch, char non,
-                   std::map<char, std::vector<char>> &followSet) {
-  return std::find(followSet[non].begin(), followSet[non].end(), ch) ==
-         followSet[non].end();
-}
-
-// 获取follow集
-std::map<char, std::vector<char>>
-getFollowSet(const std::set<char> &nonterminals,
-             const std::set<char> &terminals,
-             const std::unordered_map<char, std::vector<std::string>> &grammar,
-             const std::map<std::string, std::vector<char>> &firstSet) {
-  std::map<char, std::vector<char>> followSet;
-  for (auto non : nonterminals) {
-    if (non == beginSymbol) // 文法开始符的follow集中有'#'
-      followSet[non].push_back('#');
-  }
-  bool changed = true;
-  while (changed) {
-    changed = false;
-    for (const auto &[left, rights] : grammar) {
-      for (const auto &prod : rights) {
-        for (size_t i = 0; i < prod.size(); ++i) {
-          char B = prod[i];
-          // 如果B是非终结符
-          if (nonterminals.find(B) != nonterminals.end()) {
-            size_t k = i + 1;
-            // k指向B的后继字符
-            while (k < prod.size()) {
-              char C = prod[k];
-              // 如果后继字符是终结符则直接加入
-              if (terminals.find(C) != terminals.end()) {
-                // 检查是否重复
-                if (isNotRepeated(C, B, followSet)) {
-                  followSet[B].push_back(C);
-                  changed = true;
-                }
-                break;
-              } else {
-                // 如果后继字符是非终结符则加入产生部左式的first集
-                std::string str{C};
-                auto fs = firstSet.at(str);
-                bool containsEpsilon =
-                    std::find(fs.begin(), fs.end(), ' ') != fs.end();
-                fs.erase(std::remove(fs.begin(), fs.end(), ' '), fs.end());
-                size_t oldSize = followSet[B].size();
-                mergeAndDeduplicate(followSet[B], fs);
-                if (followSet[B].size() != oldSize) {
-                  changed = true;
-                }
-                if (!containsEpsilon) {
-                  break;
-                }
-                ++k;
-              }
-            }
-            if (k == prod.size()) {
-              size_t oldSize = followSet[B].size();
-              mergeAndDeduplicate(followSet[B], followSet[left]);
-              if (followSet[B].size() != oldSize) {
-                changed = true;
-              }
-            }
-          }
-        }
-      }
-    }
-  }
-  return followSet;
-}
-
-// 构造LL(1)分析表
-std::map<char, std::map<char, std::string>>
-LL1(const std::map<std::string, std::vector<char>> &firstSet,
-    const std::map<char, std::vector<char>> &followSet,
-    const std::set<char> &terminals,
-    const std::unordered_map<char, std::vector<std::string>> &grammar) {
-  std::map<char, std::map<char, std::string>> list;
-  // 对于每一个left ::= right(exp1 | exp2 | exp3 |...)
-  for (const auto &[A, exps] : grammar) {
-    for (const auto &alpha : exps) {
-      for (const auto &a : firstSet.at(alpha)) {
-        // 对first(alpha)中每一个终结符a,置list[A][a]=alpha
-        if (terminals.find(a) != terminals.end()) {
-          list[A][a] = alpha;
-        } else if (a == ' ') {
-          // 若first(alpha)中含有ε
-          // 则对follow(A)中的每一个符号b,置list[A][b]=alpha
-          for (const auto &b : followSet.at(A)) {
-            list[A][b] = alpha;
-          }
-        }
-      }
-    }
-    for (const auto &terminal : terminals) {
-      auto line = list[A];
-      // 对于list中的其他情况置为出错
-      if (line.find(terminal) == line.end())
-        list[A][terminal] = "NULL";
-      if (line.find('#') == line.end())
-        list[A]['#'] = "NULL";
-    }
-  }
-  return list;
-}
-
 // 计算每一列的最大宽度
 std::vector<size_t>
 calculateColumnWidths(const std::map<char, std::map<char, std::string>> &list) {
@@ -337,108 +253,47 @@ void printInfo(const std::map<char, std::map<char, std::string>> &list) {
   }
 }
 
-bool isOperation(char ch) {
-  return ch == '(' || ch == ')' || ch == '+' || ch == '*';
-}
-
-// 对给定符号串进行词法分析
-std::string lexAnalyze(const std::string &str) {
-  std::string newStr{};
-  for (int i = 0; i < str.size(); i++) {
-    switch (str[i]) {
-    case '(':
-      newStr += "(";
-      break;
-    case ')':
-      newStr += ")";
-      break;
-    case '+':
-      newStr += "+";
-      break;
-    case '*':
-      newStr += "*";
-      break;
-    default:
-      while (true) {
-        // 一直读取字符直到字符为操作符
-        if (!isOperation(str[i]))
-          ++i;
-        else {
-          newStr += "i";
-          break;
-        }
-      }
-      --i;
-    }
-  }
-  return newStr;
-}
-
-// 分析符号串是否为文法所定义
-bool LL1Analyze(std::map<char, std::map<char, std::string>> &list,
-                std::set<char> &nonterminals, std::string &str) {
-  // 初始化分析栈
-  std::vector<char> analyzeStack{};
-  analyzeStack.push_back('#');
-  analyzeStack.push_back(beginSymbol);
-  // 初始化符号串栈
-  std::vector<char> strStack{};
-  strStack.push_back('#');
-  for (int i = str.size() - 1; i >= 0; --i) {
-    strStack.push_back(str[i]);
-  }
-
-  // 打印分析过程
-  std::cout << "步骤\t分析栈\t输入串\t所用表达式\n";
-  int id = 1;
-  while (!analyzeStack.empty() && !strStack.empty()) {
-    std::cout << id++ << "\t";
-    for (int i = 0; i < analyzeStack.size(); i++) {
-      std::cout << analyzeStack[i];
-    }
-    std::cout << "\t";
-    for (int i = strStack.size() - 1; i >= 0; --i) {
-      std::cout << strStack[i];
-    }
-    std::cout << "\t";
-    
-    char topAnalyze = analyzeStack.back();
-    char topStr = strStack.back();
-    if (topAnalyze == topStr) {
-      // 终结符匹配
-      analyzeStack.pop_back();
-      strStack.pop_back();
-      std::cout << "\n";
-    } else if (nonterminals.find(topAnalyze) != nonterminals.end()) {
-      // 非终结符处理
-      if (list[topAnalyze][topStr] != "NULL") {
-        analyzeStack.pop_back();
-        std::string production = list[topAnalyze][topStr];
-        std::cout << topAnalyze << "->" << production << "\n";
-        if (production != " ") {
-          for (int i = production.size() - 1; i >= 0; --i) {
-            analyzeStack.push_back(production[i]);
-          }
-        }
-      } else {
-        // 无法找到对应的产生式
-        std::cout << "\n";
-        return false;
+int main(int argc, char *argv[]) {
+  bool stats = false;
+  std::string grammarPath;
+  std::vector<std::string> vec;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--stats") {
+      stats = true;
+    } else if (arg == "-g") {
+      if (i + 1 == argc) {
+        std::cerr << "error: option -g requires a grammar file" << std::endl;
+        return -1;
       }
+      grammarPath = argv[++i];
     } else {
-      // 终结符不匹配
-      std::cout << "\n";
-      return false;
+      vec.push_back(arg);
     }
   }
+  if (vec.empty())
+    vec = {"abc+age*80", "(abc-80(*s5)"};
 
-  // 如果两个栈都空了，说明匹配成功
-  return analyzeStack.empty() && strStack.empty();
-}
-
-int main() {
   std::unordered_map<char, std::vector<std::string>> grammar;
-  init(grammar);
+  char start;
+  if (grammarPath.empty()) {
+    init(grammar, start);
+  } else if (!loadGrammar(grammarPath, grammar, start)) {
+    std::cerr << "error: Cannot load grammar " << grammarPath << std::endl;
+    return -1;
+  }
+  // 先完整编译一次文法, 左递归的文法求first集不会结束, 非LL1文法的分析表有冲突
+  std::shared_ptr<const CompiledGrammar> compiled;
+  Status status = compileGrammar(grammar, start, compiled);
+  if (status != Status::OK) {
+    std::cerr << "error: " << statusMessage(status) << std::endl;
+    return -1;
+  }
+  if (stats) {
+    enableAllocStats();
+    printStats(grammar, start, vec);
+    return 0;
+  }
   std::cout << "初始文法: \n";
   printInfo(grammar);
   eliLeftRecursion(grammar); // 消除左递归
@@ -457,22 +312,34 @@ int main() {
   auto firstSet = getFirstSet(nonterminals, terminals, grammar);
   std::cout << "\nFirst集: \n";
   printFirstSetInfo(firstSet);
-  auto followSet = getFollowSet(nonterminals, terminals, grammar, firstSet);
+  auto followSet = getFollowSet(nonterminals, terminals, grammar, firstSet, start);
   std::cout << "\nFollow集: \n";
   printFollowSetInfo(followSet);
 
   auto list = LL1(firstSet, followSet, terminals, grammar);
   std::cout << "\n分析表:\n";
   printInfo(list);
+  CompressedTable table(list, start);
+  auto report = table.getReport();
+  std::cout << "\n压缩分析表: " << report.rows << "行 " << report.columns
+            << "列, 非出错表项" << report.entries << "/" << report.denseCells
+            << ", 占用" << report.packedBytes << "/" << report.denseBytes
+            << "字节, 压缩率" << std::fixed << std::setprecision(2)
+            << report.ratio << std::defaultfloat << "\n";
 
-  std::vector<std::string> vec{"abc+age*80", "(abc-80(*s5)"};
   std::cout << "\n分析过程:\n";
+  ParseTree cst, ast;
   for (auto &str : vec) {
-    auto newStr = lexAnalyze(str);
-    if (LL1Analyze(list, nonterminals, newStr))
+    if (LL1Analyze(table, str, &cst, &std::cout)) {
       std::cout << str << "是文法所定义的句子\n";
-    else
+      std::cout << "\n语法树:\n";
+      printTree(cst);
+      toAbstract(cst, ast);
+      std::cout << "\n抽象语法树:\n";
+      printTree(ast);
+    } else {
       std::cout << str << "不是文法所定义的句子\n";
+    }
     std::cout << std::endl;
 	}
   return 0;
@@ -0,0 +1,60 @@
+#include "allocStats.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// 每块内存前有一个头部, 记录块的大小以及分配时是否在统计
+// 未开启统计时分配和释放都不访问计数器
+struct AllocHeader {
+  size_t size;
+  bool counted;
+};
+
+static constexpr size_t headerSize = alignof(std::max_align_t);
+static_assert(sizeof(AllocHeader) <= headerSize, "头部不能超过对齐大小");
+
+static std::atomic<bool> enabled{false};
+static std::atomic<size_t> current{0}; // 当前已分配的字节数
+static std::atomic<size_t> peak{0};    // 已分配字节数的峰值
+
+void enableAllocStats() { enabled.store(true, std::memory_order_relaxed); }
+
+size_t allocatedBytes() { return current.load(std::memory_order_relaxed); }
+
+void resetAllocPeak() { peak.store(allocatedBytes(), std::memory_order_relaxed); }
+
+size_t allocPeakBytes() { return peak.load(std::memory_order_relaxed); }
+
+void *operator new(size_t size) {
+  void *block = std::malloc(size + headerSize);
+  if (!block)
+    throw std::bad_alloc();
+  auto *header = static_cast<AllocHeader *>(block);
+  header->size = size;
+  header->counted = enabled.load(std::memory_order_relaxed);
+  if (header->counted) {
+    size_t now = current.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t old = peak.load(std::memory_order_relaxed);
+    while (now > old &&
+           !peak.compare_exchange_weak(old, now, std::memory_order_relaxed)) {
+    }
+  }
+  return static_cast<char *>(block) + headerSize;
+}
+
+void operator delete(void *ptr) noexcept {
+  if (!ptr)
+    return;
+  void *block = static_cast<char *>(ptr) - headerSize;
+  auto *header = static_cast<AllocHeader *>(block);
+  if (header->counted)
+    current.fetch_sub(header->size, std::memory_order_relaxed);
+  std::free(block);
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { operator delete(ptr); }
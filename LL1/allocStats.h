@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+// 内存分配统计
+// allocStats.cpp替换了全局的operator new/delete, 链接该文件的程序才能使用
+// 默认不统计, 调用enableAllocStats之后分配的内存才计入已分配字节数和峰值
+
+// 开始统计内存分配
+void enableAllocStats();
+
+// 当前已分配的字节数
+size_t allocatedBytes();
+
+// 将峰值重置为当前已分配的字节数
+void resetAllocPeak();
+
+// 上次重置以来已分配字节数的峰值
+size_t allocPeakBytes();
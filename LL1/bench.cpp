@@ -0,0 +1,401 @@
+// LL(1)语法分析器性能测试
+// 用法: ll1_bench [-g 文法文件] [-n 句子数] [-l 句子长度] [-r 重复次数] [-s 随机种子]
+//                 [-t 线程数]
+// 由文法随机推导出合法句子, 并对其随机变异得到非法句子,
+// 测量各个文法分析阶段的耗时和LL1Analyze的吞吐量
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "compressedTable.h"
+#include "grammar.h"
+#include "parseTree.h"
+#include "parser.h"
+#include "tinyCompiler.h"
+
+using Grammar = std::unordered_map<char, std::vector<std::string>>;
+using Clock = std::chrono::steady_clock;
+
+// 重复执行f并返回平均耗时(微秒)
+template <typename F> double timeIt(size_t repeat, F &&f) {
+  auto begin = Clock::now();
+  for (size_t i = 0; i < repeat; i++)
+    f();
+  std::chrono::duration<double, std::micro> elapsed = Clock::now() - begin;
+  return elapsed.count() / repeat;
+}
+
+// 求每个非终结符推导出终结符串所需的最小推导高度
+// 生成句子时依次选择高度更小的产生式, 保证推导能够结束
+std::map<char, size_t> getHeights(const Grammar &grammar,
+                                  const std::set<char> &nonterminals) {
+  const size_t inf = std::numeric_limits<size_t>::max();
+  std::map<char, size_t> height;
+  for (char non : nonterminals)
+    height[non] = inf;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const auto &[non, exps] : grammar) {
+      for (const auto &exp : exps) {
+        size_t h = 0;
+        for (char ch : exp) {
+          if (nonterminals.find(ch) != nonterminals.end())
+            h = std::max(h, height[ch]);
+        }
+        if (h != inf && h + 1 < height[non]) {
+          height[non] = h + 1;
+          changed = true;
+        }
+      }
+    }
+  }
+  return height;
+}
+
+// 产生式的推导高度
+size_t getHeight(const std::string &exp, const std::set<char> &nonterminals,
+                 const std::map<char, size_t> &height) {
+  size_t h = 0;
+  for (char ch : exp) {
+    if (nonterminals.find(ch) != nonterminals.end())
+      h = std::max(h, height.at(ch));
+  }
+  return h;
+}
+
+// 从文法开始符做随机最左推导, 得到长度约为length的终结符串
+// 已生成的符号不足length时优先选择含非终结符的产生式, 使句子继续增长,
+// 达到length后只选择推导高度最小的产生式, 使推导尽快结束
+std::string generate(const Grammar &grammar, char start,
+                     const std::set<char> &nonterminals,
+                     const std::map<char, size_t> &height, size_t length,
+                     std::mt19937 &rng) {
+  std::string sentence;
+  std::vector<char> stack{start};
+  while (!stack.empty()) {
+    char top = stack.back();
+    stack.pop_back();
+    if (nonterminals.find(top) == nonterminals.end()) {
+      if (top != ' ')
+        sentence += top;
+      continue;
+    }
+    const auto &exps = grammar.at(top);
+    const std::string *choice;
+    if (sentence.size() + stack.size() < length) {
+      std::vector<const std::string *> growing;
+      for (const auto &exp : exps) {
+        if (getHeight(exp, nonterminals, height) > 0)
+          growing.push_back(&exp);
+      }
+      if (growing.empty())
+        choice = &exps[rng() % exps.size()];
+      else
+        choice = growing[rng() % growing.size()];
+    } else {
+      std::vector<const std::string *> best;
+      size_t bestHeight = std::numeric_limits<size_t>::max();
+      for (const auto &exp : exps) {
+        size_t h = getHeight(exp, nonterminals, height);
+        if (h < bestHeight) {
+          bestHeight = h;
+          best.clear();
+        }
+        if (h == bestHeight)
+          best.push_back(&exp);
+      }
+      choice = best[rng() % best.size()];
+    }
+    for (auto iter = choice->rbegin(); iter != choice->rend(); ++iter)
+      stack.push_back(*iter);
+  }
+  return sentence;
+}
+
+// 随机删除、插入或替换一个符号, 得到(大概率)非法的句子
+std::string mutate(std::string sentence, const std::vector<char> &terminals,
+                   std::mt19937 &rng) {
+  char ch = terminals[rng() % terminals.size()];
+  size_t pos = sentence.empty() ? 0 : rng() % sentence.size();
+  switch (sentence.empty() ? 1 : rng() % 3) {
+  case 0:
+    sentence.erase(pos, 1);
+    break;
+  case 1:
+    sentence.insert(sentence.begin() + pos, ch);
+    break;
+  default:
+    sentence[pos] = ch;
+    break;
+  }
+  return sentence;
+}
+
+// 将终结符串转换为词法单元序列, 运算对象i随机取标识符或常数
+std::vector<Token> toTokens(const std::string &sentence, std::mt19937 &rng) {
+  std::vector<Token> tokens;
+  tokens.reserve(sentence.size());
+  for (char ch : sentence) {
+    if (ch == 'i') {
+      if (rng() % 2)
+        tokens.push_back({IDENTIFIER, "x" + std::to_string(rng() % 100)});
+      else
+        tokens.push_back({CONSTANT, std::to_string(rng() % 1000)});
+    } else {
+      tokens.push_back({OPERATOR, std::string{ch}});
+    }
+  }
+  return tokens;
+}
+
+// 每个终结符还原为源串后能否经词法分析得到同一终结符
+// 不能时源串无法表示文法的句子, 例如以字母为终结符的文法
+bool isLexable(const std::set<char> &terminals) {
+  for (char ch : terminals) {
+    if (ch == 'i')
+      continue;
+    auto tokens = analyzeStr(std::string{ch}, keywords);
+    if (tokens.size() != 1 || toTerminal(tokens[0]) != ch)
+      return false;
+  }
+  return true;
+}
+
+// 将词法单元序列还原为源串
+std::string toSource(const std::vector<Token> &tokens) {
+  std::string src;
+  for (const auto &token : tokens) {
+    src += token.value;
+    src += ' ';
+  }
+  return src;
+}
+
+struct Sample {
+  std::vector<Token> tokens;
+  std::string src;
+};
+
+size_t countSymbols(const std::vector<Sample> &samples) {
+  size_t symbols = 0;
+  for (const auto &sample : samples)
+    symbols += sample.tokens.size();
+  return symbols;
+}
+
+// 打印一行吞吐量
+void printRate(const std::string &name, size_t sentences, size_t symbols,
+               double seconds, size_t accepted) {
+  std::cout << std::setw(14) << std::fixed << std::setprecision(0)
+            << sentences / seconds << std::setw(14) << symbols / seconds
+            << std::setw(8) << accepted << "/" << std::setw(6) << std::left
+            << sentences << std::right << "  " << name << "\n";
+}
+
+// 解析所有句子, 打印吞吐量并返回被接受的句子数
+template <typename F>
+size_t measure(const std::string &name, const std::vector<Sample> &samples,
+               F &&analyze) {
+  size_t accepted = 0;
+  auto begin = Clock::now();
+  for (const auto &sample : samples)
+    accepted += analyze(sample);
+  std::chrono::duration<double> elapsed = Clock::now() - begin;
+  printRate(name, samples.size(), countSymbols(samples), elapsed.count(),
+            accepted);
+  return accepted;
+}
+
+// 多个线程共享同一个编译后的文法, 各自使用自己的ParseWorkspace解析全部句子
+// 返回被接受的句子总数
+size_t measureShared(const std::string &name, const std::vector<Sample> &samples,
+                   const CompiledGrammar &compiled, size_t threads) {
+  LexerConfig config;
+  std::atomic<size_t> accepted{0};
+  std::vector<std::thread> workers;
+  auto begin = Clock::now();
+  for (size_t t = 0; t < threads; t++) {
+    workers.emplace_back([&]() {
+      ParseWorkspace workspace;
+      size_t count = 0;
+      for (const auto &sample : samples)
+        count += parse(compiled, config, sample.src, workspace) == Status::OK;
+      accepted += count;
+    });
+  }
+  for (auto &worker : workers)
+    worker.join();
+  std::chrono::duration<double> elapsed = Clock::now() - begin;
+  printRate(name, samples.size() * threads, countSymbols(samples) * threads,
+            elapsed.count(), accepted);
+  return accepted;
+}
+
+int main(int argc, char *argv[]) {
+  std::string grammarPath;
+  size_t count = 2000, length = 50, repeat = 200;
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  unsigned seed = 1;
+  for (int i = 1; i < argc; i += 2) {
+    std::string opt = argv[i];
+    if (i + 1 == argc) {
+      std::cerr << "error: option " << opt << " requires a value\n";
+      return -1;
+    }
+    if (opt == "-g")
+      grammarPath = argv[i + 1];
+    else if (opt == "-n")
+      count = std::strtoul(argv[i + 1], nullptr, 10);
+    else if (opt == "-l")
+      length = std::strtoul(argv[i + 1], nullptr, 10);
+    else if (opt == "-r")
+      repeat = std::strtoul(argv[i + 1], nullptr, 10);
+    else if (opt == "-s")
+      seed = std::strtoul(argv[i + 1], nullptr, 10);
+    else if (opt == "-t")
+      threads = std::strtoul(argv[i + 1], nullptr, 10);
+    else {
+      std::cerr << "error: unknown option " << opt << "\n";
+      return -1;
+    }
+  }
+  if (count == 0 || repeat == 0 || threads == 0) {
+    std::cerr << "error: -n, -r and -t must be positive\n";
+    return -1;
+  }
+
+  Grammar rawGrammar;
+  char start;
+  if (grammarPath.empty()) {
+    init(rawGrammar, start);
+  } else if (!loadGrammar(grammarPath, rawGrammar, start)) {
+    std::cerr << "error: cannot load grammar " << grammarPath << "\n";
+    return -1;
+  }
+
+  std::shared_ptr<const CompiledGrammar> compiled;
+  Status status = compileGrammar(rawGrammar, start, compiled);
+  if (status != Status::OK) {
+    std::cerr << "error: " << statusMessage(status) << "\n";
+    return -1;
+  }
+
+  // 文法分析各阶段的耗时
+  const auto &grammar = compiled->grammar;
+  const auto &nonterminals = compiled->nonterminals;
+  const auto &terminals = compiled->terminals;
+  const auto &firstSet = compiled->firstSet;
+  const auto &followSet = compiled->followSet;
+  const auto &list = compiled->list;
+  const auto &table = compiled->table;
+  std::cout << "文法: " << nonterminals.size() << "个非终结符, "
+            << terminals.size() << "个终结符\n";
+  std::cout << "\n文法分析各阶段平均耗时(微秒, 重复" << repeat << "次):\n";
+  auto phase = [&](const std::string &name, double us) {
+    std::cout << "  " << std::setw(24) << std::left << name << std::right
+              << std::setw(12) << std::fixed << std::setprecision(2) << us
+              << "\n";
+  };
+  phase("eliLeftRecursion", timeIt(repeat, [&]() {
+          Grammar copy = rawGrammar;
+          eliLeftRecursion(copy);
+        }));
+  phase("getSymbols", timeIt(repeat, [&]() { getSymbols(grammar); }));
+  phase("getFirstSet", timeIt(repeat, [&]() {
+          getFirstSet(nonterminals, terminals, grammar);
+        }));
+  phase("getFollowSet", timeIt(repeat, [&]() {
+          getFollowSet(nonterminals, terminals, grammar, firstSet, start);
+        }));
+  phase("LL1", timeIt(repeat, [&]() {
+          LL1(firstSet, followSet, terminals, grammar);
+        }));
+  phase("CompressedTable", timeIt(repeat, [&]() { CompressedTable(list, start); }));
+
+  // 生成测试句子
+  std::mt19937 rng(seed);
+  auto height = getHeights(grammar, nonterminals);
+  for (char non : nonterminals) {
+    if (height[non] == std::numeric_limits<size_t>::max()) {
+      std::cerr << "error: " << non << " derives no terminal string\n";
+      return -1;
+    }
+  }
+  std::vector<char> terminalList(terminals.begin(), terminals.end());
+  std::vector<Sample> valid, invalid;
+  size_t validSymbols = 0;
+  for (size_t i = 0; i < count; i++) {
+    std::string sentence =
+        generate(grammar, start, nonterminals, height, length, rng);
+    Sample good{toTokens(sentence, rng), {}};
+    good.src = toSource(good.tokens);
+    validSymbols += good.tokens.size();
+    valid.push_back(std::move(good));
+    Sample bad{toTokens(mutate(sentence, terminalList, rng), rng), {}};
+    bad.src = toSource(bad.tokens);
+    invalid.push_back(std::move(bad));
+  }
+  std::cout << "\n句子: " << count << "个合法句子(平均长度" << std::fixed
+            << std::setprecision(1) << static_cast<double>(validSymbols) / count
+            << "), " << count << "个变异句子\n";
+
+  // LL1Analyze的吞吐量
+  std::cout << "\nLL1Analyze吞吐量:\n"
+            << "       句子/秒       符号/秒          接受  输入\n";
+  ParseTree tree;
+  auto fromTokens = [&](const Sample &sample) {
+    TokenSpan span{sample.tokens};
+    return LL1Analyze(table, span);
+  };
+  auto withTree = [&](const Sample &sample) {
+    TokenSpan span{sample.tokens};
+    return LL1Analyze(table, span, &tree);
+  };
+  auto fromSource = [&](const Sample &sample) {
+    return LL1Analyze(table, sample.src);
+  };
+  // 合法句子未被全部接受时, 该行测得的主要是出错路径的耗时
+  std::vector<std::string> rejected;
+  auto expectAll = [&](const std::string &name, size_t accepted,
+                       size_t total) {
+    if (accepted != total)
+      rejected.push_back(name + ": " + std::to_string(total - accepted) + "/" +
+                         std::to_string(total));
+  };
+  bool lexable = isLexable(terminals);
+  expectAll("合法/词法单元", measure("合法/词法单元", valid, fromTokens),
+            count);
+  expectAll("合法/词法单元+建树",
+            measure("合法/词法单元+建树", valid, withTree), count);
+  if (lexable)
+    expectAll("合法/源串(流水线)",
+              measure("合法/源串(流水线)", valid, fromSource), count);
+  measure("变异/词法单元", invalid, fromTokens);
+  if (lexable) {
+    measure("变异/源串(流水线)", invalid, fromSource);
+    std::string name = "合法/源串(" + std::to_string(threads) + "线程共享文法)";
+    expectAll(name, measureShared(name, valid, *compiled, threads),
+              count * threads);
+  } else {
+    std::cout << "\n注意: 文法的终结符不全是运算对象i或单字符运算符、界符, "
+                 "无法由源串经词法分析得到, 跳过源串各行\n";
+  }
+  if (!rejected.empty()) {
+    std::cout << "\n警告: 以下各行有合法句子未被接受, 文法可能不是LL(1)文法:\n";
+    for (const auto &line : rejected)
+      std::cout << "  " << line << "\n";
+  }
+  return 0;
+}
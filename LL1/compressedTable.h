@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// 压缩的LL(1)分析表
+// 采用行位移(梳状向量)压缩: 每行只保存非出错的表项, 各行错开一定位移后
+// 合并存放在同一个数组next中, check数组记录每个位置属于哪一行
+// 查表时 idx = base[行] + 列, check[idx]等于该行则next[idx]为产生式编号, 否则出错
+class CompressedTable {
+public:
+  // 压缩效果
+  struct Report {
+    size_t rows;        // 非终结符个数
+    size_t columns;     // 终结符个数(含'#')
+    size_t entries;     // 非出错表项个数
+    size_t denseCells;  // 不压缩时的表项个数
+    size_t packedCells; // 压缩后next数组的长度
+    size_t denseBytes;  // 不压缩时占用的字节数
+    size_t packedBytes; // 压缩后占用的字节数
+    double ratio;       // 压缩后与压缩前字节数之比
+  };
+
+  // 空表, 任何查找都出错
+  CompressedTable() {
+    rowId.fill(-1);
+    colId.fill(-1);
+  }
+
+  // 由LL1()构造的分析表压缩得到, start为文法开始符
+  CompressedTable(const std::map<char, std::map<char, std::string>> &list,
+                  char start)
+      : start(start) {
+    rowId.fill(-1);
+    colId.fill(-1);
+    std::map<std::string, uint16_t> productionId;
+    // 为每行每列编号, 并收集每行的非出错表项
+    std::vector<std::vector<std::pair<int16_t, uint16_t>>> rowEntries;
+    for (const auto &[non, line] : list) {
+      rowId[static_cast<unsigned char>(non)] =
+          static_cast<int16_t>(rowEntries.size());
+      rowEntries.emplace_back();
+      for (const auto &[ter, exp] : line) {
+        auto &col = colId[static_cast<unsigned char>(ter)];
+        if (col < 0)
+          col = columns++;
+        if (exp == "NULL")
+          continue;
+        auto [iter, inserted] =
+            productionId.emplace(exp, static_cast<uint16_t>(productions.size()));
+        if (inserted)
+          productions.push_back(exp);
+        rowEntries.back().emplace_back(col, iter->second);
+      }
+      entries += rowEntries.back().size();
+    }
+    // 表项多的行先放, 较稀疏的行更容易填进剩余的空位
+    std::vector<size_t> order(rowEntries.size());
+    for (size_t i = 0; i < order.size(); i++)
+      order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return rowEntries[a].size() > rowEntries[b].size();
+    });
+    base.assign(rowEntries.size(), 0);
+    for (size_t row : order) {
+      const auto &cells = rowEntries[row];
+      if (cells.empty())
+        continue;
+      // 寻找最小的位移, 使该行所有表项都落在空位上
+      int32_t offset = 0;
+      while (true) {
+        bool fits = true;
+        for (const auto &[col, prod] : cells) {
+          size_t idx = offset + col;
+          if (idx < check.size() && check[idx] >= 0) {
+            fits = false;
+            break;
+          }
+        }
+        if (fits)
+          break;
+        offset++;
+      }
+      base[row] = offset;
+      for (const auto &[col, prod] : cells) {
+        size_t idx = offset + col;
+        if (idx >= check.size()) {
+          check.resize(idx + 1, -1);
+          next.resize(idx + 1, 0);
+        }
+        check[idx] = static_cast<int16_t>(row);
+        next[idx] = prod;
+      }
+    }
+  }
+
+  // 查找list[non][ter], 出错时返回nullptr
+  const std::string *lookup(char non, char ter) const {
+    int16_t row = rowId[static_cast<unsigned char>(non)];
+    int16_t col = colId[static_cast<unsigned char>(ter)];
+    if (row < 0 || col < 0)
+      return nullptr;
+    size_t idx = base[row] + col;
+    if (idx >= check.size() || check[idx] != row)
+      return nullptr;
+    return &productions[next[idx]];
+  }
+
+  char getStart() const { return start; }
+
+  bool isNonterminal(char ch) const {
+    return rowId[static_cast<unsigned char>(ch)] >= 0;
+  }
+
+  Report getReport() const {
+    Report report{};
+    report.rows = base.size();
+    report.columns = columns;
+    report.entries = entries;
+    report.denseCells = report.rows * report.columns;
+    report.packedCells = next.size();
+    // 不压缩时每个表项保存一个产生式编号
+    report.denseBytes = report.denseCells * sizeof(uint16_t);
+    report.packedBytes = next.size() * sizeof(uint16_t) +
+                         check.size() * sizeof(int16_t) +
+                         base.size() * sizeof(int32_t);
+    report.ratio = report.denseBytes == 0
+                       ? 1.0
+                       : static_cast<double>(report.packedBytes) /
+                             report.denseBytes;
+    return report;
+  }
+
+private:
+  std::array<int16_t, 256> rowId; // 非终结符 -> 行号, -1表示不是非终结符
+  std::array<int16_t, 256> colId; // 终结符 -> 列号, -1表示不是终结符
+  char start = '\0';               // 文法开始符
+  int16_t columns = 0;
+  size_t entries = 0;
+  std::vector<int32_t> base;      // 每行的位移
+  std::vector<uint16_t> next;     // 产生式编号
+  std::vector<int16_t> check;     // 每个位置所属的行, -1表示空位
+  std::vector<std::string> productions; // 产生式右部
+};
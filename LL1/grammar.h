@@ -0,0 +1,470 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 初始化文法, start为文法开始符
+inline void init(std::unordered_map<char, std::vector<std::string>> &grammar,
+                 char &start) {
+  grammar.insert(std::make_pair('E', std::vector<std::string>{"E+T", "T"}));
+  grammar.insert(std::make_pair('T', std::vector<std::string>{"T*F", "F"}));
+  grammar.insert(std::make_pair('F', std::vector<std::string>{"(E)", "i"}));
+  start = 'E';
+}
+
+// 从文件读取文法, 每行一个非终结符的产生式, 如 E->E+T|T
+// 第一行的左部为文法开始符, 空串写作ε或留空, 产生式中的空白会被忽略
+inline bool
+loadGrammar(const std::string &path,
+            std::unordered_map<char, std::vector<std::string>> &grammar,
+            char &start) {
+  std::ifstream file(path);
+  if (!file.is_open())
+    return false;
+  grammar.clear();
+  bool first = true;
+  std::string line;
+  while (std::getline(file, line)) {
+    line.erase(std::remove_if(line.begin(), line.end(),
+                              [](unsigned char ch) { return std::isspace(ch); }),
+               line.end());
+    if (line.empty())
+      continue;
+    auto arrow = line.find("->");
+    if (arrow != 1)
+      return false;
+    char non = line[0];
+    if (first) {
+      start = non;
+      first = false;
+    }
+    std::string rest = line.substr(3) + "|";
+    size_t begin = 0;
+    for (size_t end = rest.find('|'); end != std::string::npos;
+         begin = end + 1, end = rest.find('|', begin)) {
+      std::string exp = rest.substr(begin, end - begin);
+      if (exp.empty() || exp == "ε")
+        exp = " ";
+      grammar[non].push_back(exp);
+    }
+  }
+  return !first;
+}
+
+// 获取非终结符和终结符
+inline std::pair<std::set<char>, std::set<char>>
+getSymbols(const std::unordered_map<char, std::vector<std::string>> &grammar) {
+  std::set<char> nonterminals;
+  std::set<char> terminals;
+  // 获取非终结符集合
+  for (const auto &[non, exp] : grammar) {
+    nonterminals.insert(non);
+  }
+  // 获取终结符集合
+  for (const auto &[Non, exp] : grammar) {
+    for (const auto &str : exp) {
+      for (const auto &ch : str) {
+        // 如果在非终结符集合中没有找到
+        if (nonterminals.find(ch) == nonterminals.end()) {
+          if (ch != ' ')
+            terminals.insert(ch);
+        }
+      }
+    }
+  }
+  return std::make_pair(nonterminals, terminals);
+}
+
+// 产生式中是否含有直接左递归
+inline bool hasDirectLeftRecursion(char non,
+                                   const std::vector<std::string> &exp) {
+  for (const auto &prod : exp) {
+    if (prod[0] == non)
+      return true;
+  }
+  return false;
+}
+
+// 为含直接左递归的非终结符选择消除左递归时引入的新非终结符, 结果写入names
+// 优先使用non+26, 该字符已在文法中出现或不是可打印字符时,
+// 依次选择未使用的大写字母和其他可打印字符('#'除外)
+// 按非终结符的顺序选择, 同一文法总是得到相同的结果, 没有可用的字符时返回false
+inline bool getNewNonterminals(
+    const std::unordered_map<char, std::vector<std::string>> &grammar,
+    std::map<char, char> &names) {
+  names.clear();
+  std::set<char> used;
+  std::set<char> recursive;
+  for (const auto &[non, exp] : grammar) {
+    used.insert(non);
+    for (const auto &prod : exp)
+      used.insert(prod.begin(), prod.end());
+    if (hasDirectLeftRecursion(non, exp))
+      recursive.insert(non);
+  }
+  auto usable = [&](int ch) {
+    return ch > ' ' && ch <= '~' && ch != '#' &&
+           used.find(static_cast<char>(ch)) == used.end();
+  };
+  for (char non : recursive) {
+    int newNon = non + 26;
+    for (int ch = 'A'; !usable(newNon) && ch <= 'Z'; ch++)
+      newNon = ch;
+    for (int ch = '!'; !usable(newNon) && ch <= '~'; ch++)
+      newNon = ch;
+    if (!usable(newNon))
+      return false;
+    names[non] = static_cast<char>(newNon);
+    used.insert(static_cast<char>(newNon));
+  }
+  return true;
+}
+
+// 消除单个非终结符的直接左递归, newNon为引入的新非终结符, 结果写入newGrammar
+// 返回引入的新非终结符, 没有直接左递归时返回'\0'
+inline char
+eliLeftRecursion(char non, const std::vector<std::string> &exp, char newNon,
+                 std::unordered_map<char, std::vector<std::string>> &newGrammar) {
+  std::vector<std::string> alpha; // 直接左递归部分
+  std::vector<std::string> beta;  // 其他部分
+  for (const auto &prod : exp) {
+    if (prod[0] == non) { // 直接左递归
+      alpha.push_back(prod.substr(1));
+    } else {
+      beta.push_back(prod);
+    }
+  }
+  if (!alpha.empty()) { // 存在左递归
+    for (auto &b : beta) {
+      b += newNon;
+    }
+    std::vector<std::string> newExp;
+    for (auto &a : alpha) {
+      newExp.push_back(a + newNon);
+    }
+    newExp.push_back(" "); // 空串
+    // 构建新的语法表
+    newGrammar[non] = beta;
+    newGrammar[newNon] = newExp;
+    return newNon;
+  }
+  newGrammar[non] = exp;
+  return '\0';
+}
+
+// 消除左递归, 没有可用的字符作为新的非终结符时返回false且不修改文法
+inline bool
+eliLeftRecursion(std::unordered_map<char, std::vector<std::string>> &grammar) {
+  std::map<char, char> names;
+  if (!getNewNonterminals(grammar, names))
+    return false;
+  std::unordered_map<char, std::vector<std::string>> newGrammar;
+  for (auto &[non, exp] : grammar) {
+    auto iter = names.find(non);
+    eliLeftRecursion(non, exp, iter == names.end() ? '\0' : iter->second,
+                     newGrammar);
+  }
+  grammar = newGrammar;
+  return true;
+}
+
+// 消除直接左递归后是否仍有左递归(间接左递归)
+// 若A的产生式右部在若干可空的非终结符之后出现B, 则连一条A->B的边, 有环即有左递归
+inline bool
+hasLeftRecursion(const std::unordered_map<char, std::vector<std::string>> &grammar,
+                 const std::set<char> &nonterminals) {
+  // 求可空的非终结符
+  std::set<char> nullable;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const auto &[non, exps] : grammar) {
+      if (nullable.count(non))
+        continue;
+      for (const auto &exp : exps) {
+        bool all = true;
+        for (char ch : exp) {
+          if (ch != ' ' && !nullable.count(ch)) {
+            all = false;
+            break;
+          }
+        }
+        if (all) {
+          nullable.insert(non);
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+  std::map<char, std::set<char>> edges;
+  for (const auto &[non, exps] : grammar) {
+    for (const auto &exp : exps) {
+      for (char ch : exp) {
+        if (ch == ' ')
+          continue;
+        if (!nonterminals.count(ch))
+          break;
+        edges[non].insert(ch);
+        if (!nullable.count(ch))
+          break;
+      }
+    }
+  }
+  // 深度优先搜索找环, 0未访问 1正在访问 2已访问
+  std::map<char, int> state;
+  for (char root : nonterminals) {
+    if (state[root] != 0)
+      continue;
+    std::vector<std::pair<char, std::set<char>::const_iterator>> stack;
+    state[root] = 1;
+    stack.emplace_back(root, edges[root].cbegin());
+    while (!stack.empty()) {
+      auto &[node, iter] = stack.back();
+      if (iter == edges[node].cend()) {
+        state[node] = 2;
+        stack.pop_back();
+        continue;
+      }
+      char next = *iter++;
+      if (state[next] == 1)
+        return true;
+      if (state[next] == 0) {
+        state[next] = 1;
+        stack.emplace_back(next, edges[next].cbegin());
+      }
+    }
+  }
+  return false;
+}
+
+inline bool isNotRepeated(char ch, std::string str,
+                          std::map<std::string, std::vector<char>> &firstSet) {
+  return std::find(firstSet[str].begin(), firstSet[str].end(), ch) ==
+         firstSet[str].end();
+}
+
+// 求产生式右部exp的first集, 返回展开的句型个数
+inline size_t getProductionFirst(
+    const std::string &exp, const std::set<char> &terminals,
+    const std::unordered_map<char, std::vector<std::string>> &grammar,
+    std::map<std::string, std::vector<char>> &firstSet) {
+  firstSet[exp].clear();
+  std::vector<std::string> tempExps{exp};
+  for (size_t j = 0; j < tempExps.size(); j++) {
+    auto tmp = tempExps[j];
+    // 如果第一个字符是空字符且长度不等于1则删除该字符
+    if (tmp[0] == ' ' && tmp.size() != 1)
+      tmp.erase(0, 1);
+    if (tmp[0] == ' ' && tmp.size() == 1) {
+      if (isNotRepeated(' ', exp, firstSet))
+        firstSet[exp].push_back(' ');
+    }
+    // 如果表达式的首个符号是终结符
+    else if (terminals.find(tmp[0]) != terminals.end()) {
+      if (isNotRepeated(tmp[0], exp, firstSet))
+        firstSet[exp].push_back(tmp[0]); // 将符号加入first集
+    } else {
+      auto alpha = tmp.substr(1); // 除去第一个符号的表达式
+      auto nextExps = grammar.at(tmp[0]); // 由第一个符号产生的表达式
+      for (auto prod : nextExps) {
+        tempExps.push_back(prod + alpha);
+      }
+    }
+  }
+  return tempExps.size();
+}
+
+// 由各产生式右部的first集求非终结符non的first集
+inline void getNonterminalFirst(
+    char non, const std::unordered_map<char, std::vector<std::string>> &grammar,
+    std::map<std::string, std::vector<char>> &firstSet) {
+  std::string nonstr{non};
+  std::vector<char> first;
+  for (const auto &exp : grammar.at(non)) {
+    // 将每个产生式右部的first集加入对应的非终结符的first集
+    for (auto ch : firstSet[exp]) {
+      if (std::find(first.begin(), first.end(), ch) == first.end())
+        first.push_back(ch);
+    }
+  }
+  firstSet[nonstr] = first;
+}
+
+// 获取first集, expanded不为空时记录展开的句型总数
+inline std::map<std::string, std::vector<char>>
+getFirstSet(const std::set<char> &nonterminals, const std::set<char> &terminals,
+            const std::unordered_map<char, std::vector<std::string>> &grammar,
+            size_t *expanded = nullptr) {
+  std::map<std::string, std::vector<char>> firstSet;
+  size_t forms = 0;
+  // 求每个产生部右侧的first集
+  for (const auto &[non, exps] : grammar) {
+    for (const auto &exp : exps) {
+      forms += getProductionFirst(exp, terminals, grammar, firstSet);
+    }
+  }
+  if (expanded)
+    *expanded = forms;
+  // 求每个非终结符的first集
+  for (auto non : nonterminals) {
+    getNonterminalFirst(non, grammar, firstSet);
+  }
+  return firstSet;
+}
+
+// 合并向量去重
+inline void mergeAndDeduplicate(std::vector<char> &dest,
+                                const std::vector<char> &src) {
+  for (char c : src) {
+    if (std::find(dest.begin(), dest.end(), c) == dest.end()) {
+      dest.push_back(c);
+    }
+  }
+}
+
+inline bool isNotRepeated(char ch, char non,
+                          std::map<char, std::vector<char>> &followSet) {
+  return std::find(followSet[non].begin(), followSet[non].end(), ch) ==
+         followSet[non].end();
+}
+
+// 迭代求follow集直到不再变化, 只更新targets中非终结符的follow集
+// 其余非终结符的follow集视为已知, 返回迭代的轮数
+inline size_t
+followFixpoint(const std::set<char> &nonterminals,
+               const std::set<char> &terminals,
+               const std::unordered_map<char, std::vector<std::string>> &grammar,
+               const std::map<std::string, std::vector<char>> &firstSet,
+               std::map<char, std::vector<char>> &followSet,
+               const std::set<char> &targets) {
+  size_t iterations = 0;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    iterations++;
+    for (const auto &[left, rights] : grammar) {
+      for (const auto &prod : rights) {
+        for (size_t i = 0; i < prod.size(); ++i) {
+          char B = prod[i];
+          // 如果B是需要更新的非终结符
+          if (targets.find(B) != targets.end() &&
+              nonterminals.find(B) != nonterminals.end()) {
+            size_t k = i + 1;
+            // k指向B的后继字符
+            while (k < prod.size()) {
+              char C = prod[k];
+              // 如果后继字符是终结符则直接加入
+              if (terminals.find(C) != terminals.end()) {
+                // 检查是否重复
+                if (isNotRepeated(C, B, followSet)) {
+                  followSet[B].push_back(C);
+                  changed = true;
+                }
+                break;
+              } else {
+                // 如果后继字符是非终结符则加入产生部左式的first集
+                std::string str{C};
+                auto fs = firstSet.at(str);
+                bool containsEpsilon =
+                    std::find(fs.begin(), fs.end(), ' ') != fs.end();
+                fs.erase(std::remove(fs.begin(), fs.end(), ' '), fs.end());
+                size_t oldSize = followSet[B].size();
+                mergeAndDeduplicate(followSet[B], fs);
+                if (followSet[B].size() != oldSize) {
+                  changed = true;
+                }
+                if (!containsEpsilon) {
+                  break;
+                }
+                ++k;
+              }
+            }
+            if (k == prod.size()) {
+              size_t oldSize = followSet[B].size();
+              mergeAndDeduplicate(followSet[B], followSet[left]);
+              if (followSet[B].size() != oldSize) {
+                changed = true;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return iterations;
+}
+
+// 获取follow集, iterations不为空时记录迭代的轮数
+inline std::map<char, std::vector<char>>
+getFollowSet(const std::set<char> &nonterminals,
+             const std::set<char> &terminals,
+             const std::unordered_map<char, std::vector<std::string>> &grammar,
+             const std::map<std::string, std::vector<char>> &firstSet,
+             char start, size_t *iterations = nullptr) {
+  std::map<char, std::vector<char>> followSet;
+  for (auto non : nonterminals) {
+    followSet[non]; // 不出现在任何产生式右部的非终结符follow集为空
+    if (non == start) // 文法开始符的follow集中有'#'
+      followSet[non].push_back('#');
+  }
+  size_t rounds = followFixpoint(nonterminals, terminals, grammar, firstSet,
+                                followSet, nonterminals);
+  if (iterations)
+    *iterations = rounds;
+  return followSet;
+}
+
+// 构造分析表中非终结符A对应的一行
+inline void
+LL1Row(char A, const std::vector<std::string> &exps,
+       const std::map<std::string, std::vector<char>> &firstSet,
+       const std::map<char, std::vector<char>> &followSet,
+       const std::set<char> &terminals,
+       std::map<char, std::map<char, std::string>> &list) {
+  list[A].clear();
+  // 对于每一个left ::= right(exp1 | exp2 | exp3 |...)
+  for (const auto &alpha : exps) {
+    for (const auto &a : firstSet.at(alpha)) {
+      // 对first(alpha)中每一个终结符a,置list[A][a]=alpha
+      if (terminals.find(a) != terminals.end()) {
+        list[A][a] = alpha;
+      } else if (a == ' ') {
+        // 若first(alpha)中含有ε
+        // 则对follow(A)中的每一个符号b,置list[A][b]=alpha
+        for (const auto &b : followSet.at(A)) {
+          list[A][b] = alpha;
+        }
+      }
+    }
+  }
+  for (const auto &terminal : terminals) {
+    auto &line = list[A];
+    // 对于list中的其他情况置为出错
+    if (line.find(terminal) == line.end())
+      line[terminal] = "NULL";
+    if (line.find('#') == line.end())
+      line['#'] = "NULL";
+  }
+}
+
+// 构造LL(1)分析表
+inline std::map<char, std::map<char, std::string>>
+LL1(const std::map<std::string, std::vector<char>> &firstSet,
+    const std::map<char, std::vector<char>> &followSet,
+    const std::set<char> &terminals,
+    const std::unordered_map<char, std::vector<std::string>> &grammar) {
+  std::map<char, std::map<char, std::string>> list;
+  for (const auto &[A, exps] : grammar) {
+    LL1Row(A, exps, firstSet, followSet, terminals, list);
+  }
+  return list;
+}
@@ -0,0 +1,331 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "grammar.h"
+
+// 文法会话
+// 保存文法及其first集、follow集和分析表, 修改产生式后只重新计算受影响的部分
+// 初始文法在消除直接左递归后不能含有左递归, 否则会话中的文法为空;
+// 会引入左递归的修改会被拒绝
+class GrammarSession {
+public:
+  using Grammar = std::unordered_map<char, std::vector<std::string>>;
+
+  GrammarSession(Grammar grammar, char start)
+      : rawGrammar(std::move(grammar)), start(start) {
+    analyzeAll();
+  }
+
+  // 增加产生式 non -> exp, 修改会引入左递归时不做修改并返回false
+  bool addProduction(char non, const std::string &exp) {
+    auto &exps = rawGrammar[non];
+    if (std::find(exps.begin(), exps.end(), exp) != exps.end())
+      return true;
+    exps.push_back(exp);
+    if (reanalyze(non))
+      return true;
+    exps.pop_back();
+    if (exps.empty())
+      rawGrammar.erase(non);
+    return false;
+  }
+
+  // 删除产生式 non -> exp, 修改会引入左递归时不做修改并返回false
+  bool removeProduction(char non, const std::string &exp) {
+    auto iter = rawGrammar.find(non);
+    if (iter == rawGrammar.end())
+      return true;
+    auto old = iter->second;
+    auto &exps = iter->second;
+    auto pos = std::find(exps.begin(), exps.end(), exp);
+    if (pos == exps.end())
+      return true;
+    exps.erase(pos);
+    if (exps.empty())
+      rawGrammar.erase(iter);
+    if (reanalyze(non))
+      return true;
+    rawGrammar[non] = std::move(old);
+    return false;
+  }
+
+  // 将产生式 non -> from 修改为 non -> to, 修改会引入左递归时不做修改并返回false
+  bool replaceProduction(char non, const std::string &from,
+                         const std::string &to) {
+    auto iter = rawGrammar.find(non);
+    if (iter == rawGrammar.end())
+      return true;
+    auto &exps = iter->second;
+    auto pos = std::find(exps.begin(), exps.end(), from);
+    if (pos == exps.end())
+      return true;
+    *pos = to;
+    if (reanalyze(non))
+      return true;
+    *pos = from;
+    return false;
+  }
+
+  const Grammar &getGrammar() const { return grammar; }
+  const std::set<char> &getNonterminals() const { return nonterminals; }
+  const std::set<char> &getTerminals() const { return terminals; }
+  const std::map<std::string, std::vector<char>> &getFirstSet() const {
+    return firstSet;
+  }
+  const std::map<char, std::vector<char>> &getFollowSet() const {
+    return followSet;
+  }
+  const std::map<char, std::map<char, std::string>> &getTable() const {
+    return list;
+  }
+  // 最近一次修改后重新构造的分析表行
+  const std::set<char> &getRebuiltRows() const { return rebuiltRows; }
+
+private:
+  // 从头分析整个文法
+  // 文法含有左递归或无法引入新的非终结符时不做修改并返回false
+  bool analyzeAll() {
+    std::map<char, char> names;
+    if (!getNewNonterminals(rawGrammar, names))
+      return false;
+    Grammar eliminated;
+    for (const auto &[non, exps] : rawGrammar) {
+      auto iter = names.find(non);
+      eliLeftRecursion(non, exps, iter == names.end() ? '\0' : iter->second,
+                       eliminated);
+    }
+    auto symbols = getSymbols(eliminated);
+    if (hasLeftRecursion(eliminated, symbols.first))
+      return false;
+    grammar = std::move(eliminated);
+    introduced = std::move(names);
+    std::tie(nonterminals, terminals) = std::move(symbols);
+    firstSet = ::getFirstSet(nonterminals, terminals, grammar);
+    followSet =
+        ::getFollowSet(nonterminals, terminals, grammar, firstSet, start);
+    list = LL1(firstSet, followSet, terminals, grammar);
+    rebuiltRows = nonterminals;
+    return true;
+  }
+
+  // 非终结符non的产生式改变后增量更新
+  // 修改后的文法含有左递归时恢复原来的文法并返回false
+  bool reanalyze(char non) {
+    std::map<char, char> names;
+    if (!getNewNonterminals(rawGrammar, names))
+      return false;
+    // 其他非终结符引入的新非终结符改变时(如修改后的产生式用到了该字符), 从头分析
+    auto others = names;
+    auto current = introduced;
+    others.erase(non);
+    current.erase(non);
+    if (others != current)
+      return analyzeAll();
+    auto named = names.find(non);
+    char newNon = named == names.end() ? '\0' : named->second;
+
+    // 消除左递归只涉及non自身和由它引入的新非终结符
+    std::set<char> edited{non};
+    auto oldIntroduced = introduced.find(non);
+    char oldNon =
+        oldIntroduced == introduced.end() ? '\0' : oldIntroduced->second;
+    if (oldNon)
+      edited.insert(oldNon);
+    Grammar saved;
+    std::vector<std::string> oldExps;
+    for (char e : edited) {
+      auto iter = grammar.find(e);
+      if (iter != grammar.end()) {
+        oldExps.insert(oldExps.end(), iter->second.begin(), iter->second.end());
+        saved[e] = std::move(iter->second);
+        grammar.erase(iter);
+      }
+    }
+    auto rawIter = rawGrammar.find(non);
+    if (rawIter != rawGrammar.end())
+      eliLeftRecursion(non, rawIter->second, newNon, grammar);
+    if (newNon)
+      edited.insert(newNon);
+
+    auto [newNonterminals, newTerminals] = getSymbols(grammar);
+    // 有左递归时求first集不会结束
+    if (hasLeftRecursion(grammar, newNonterminals)) {
+      for (char e : edited)
+        grammar.erase(e);
+      for (auto &[e, exps] : saved)
+        grammar[e] = std::move(exps);
+      return false;
+    }
+    if (newNon)
+      introduced[non] = newNon;
+    else
+      introduced.erase(non);
+    // 终结符集合改变时所有分析表行都要改变, 直接从头分析
+    if (newTerminals != terminals)
+      return analyzeAll();
+    // 清除被删除的非终结符的信息, 并记录新出现的非终结符
+    std::set<char> added;
+    for (char e : edited) {
+      if (newNonterminals.find(e) == newNonterminals.end()) {
+        firstSet.erase(std::string{e});
+        followSet.erase(e);
+        list.erase(e);
+      } else if (nonterminals.find(e) == nonterminals.end()) {
+        added.insert(e);
+      }
+    }
+    nonterminals = newNonterminals;
+
+    // first集受影响的非终结符: 被修改的非终结符, 以及产生式右部中
+    // 可能由它们开头的非终结符, 沿依赖关系向上传递
+    std::map<char, std::set<char>> firstUsers; // Y -> 首部可能为Y的非终结符
+    for (const auto &[left, exps] : grammar) {
+      for (const auto &exp : exps) {
+        for (char ch : exp) {
+          // 消除左递归后右部可能以空串开头, 如 A->βA' 中β为空串
+          if (ch == ' ')
+            continue;
+          if (nonterminals.find(ch) == nonterminals.end())
+            break;
+          firstUsers[ch].insert(left);
+        }
+      }
+    }
+    std::set<char> firstAffected;
+    std::vector<char> work;
+    for (char e : edited) {
+      if (nonterminals.find(e) != nonterminals.end()) {
+        firstAffected.insert(e);
+        work.push_back(e);
+      }
+    }
+    while (!work.empty()) {
+      char y = work.back();
+      work.pop_back();
+      for (char x : firstUsers[y]) {
+        if (firstAffected.insert(x).second)
+          work.push_back(x);
+      }
+    }
+    for (char x : firstAffected) {
+      for (const auto &exp : grammar.at(x))
+        getProductionFirst(exp, terminals, grammar, firstSet);
+    }
+    for (char x : firstAffected) {
+      getNonterminalFirst(x, grammar, firstSet);
+    }
+    // 清除不再使用的产生式右部的first集
+    for (const auto &exp : oldExps) {
+      if (exp.size() == 1 && nonterminals.find(exp[0]) != nonterminals.end())
+        continue;
+      bool used = false;
+      for (const auto &[left, exps] : grammar) {
+        if (std::find(exps.begin(), exps.end(), exp) != exps.end()) {
+          used = true;
+          break;
+        }
+      }
+      if (!used)
+        firstSet.erase(exp);
+    }
+
+    // follow集受影响的非终结符: 出现在增加或删除的产生式中的非终结符,
+    // 以及后面跟着first集改变的非终结符的非终结符
+    std::set<char> followAffected = added;
+    // 将from中有而to中没有的产生式的非终结符加入followAffected
+    auto addChanged = [&](const std::vector<std::string> &from,
+                          const std::vector<std::string> &to) {
+      for (const auto &exp : from) {
+        if (std::find(to.begin(), to.end(), exp) != to.end())
+          continue;
+        for (char ch : exp) {
+          if (nonterminals.find(ch) != nonterminals.end())
+            followAffected.insert(ch);
+        }
+      }
+    };
+    const std::vector<std::string> none;
+    for (char e : edited) {
+      auto oldIter = saved.find(e);
+      auto newIter = grammar.find(e);
+      const auto &from = oldIter == saved.end() ? none : oldIter->second;
+      const auto &to = newIter == grammar.end() ? none : newIter->second;
+      addChanged(from, to);
+      addChanged(to, from);
+    }
+    for (const auto &[left, exps] : grammar) {
+      for (const auto &exp : exps) {
+        for (size_t i = 1; i < exp.size(); i++) {
+          if (firstAffected.find(exp[i]) == firstAffected.end())
+            continue;
+          // 向前经过可空的非终结符, 遇到终结符时停止
+          for (size_t k = i; k-- > 0;) {
+            if (exp[k] == ' ')
+              continue;
+            if (nonterminals.find(exp[k]) == nonterminals.end())
+              break;
+            followAffected.insert(exp[k]);
+            const auto &first = firstSet.at(std::string{exp[k]});
+            if (std::find(first.begin(), first.end(), ' ') == first.end())
+              break;
+          }
+        }
+      }
+    }
+    // follow(A)改变时, 所有可能位于A的产生式末尾的非终结符的follow集也改变
+    work.assign(followAffected.begin(), followAffected.end());
+    while (!work.empty()) {
+      char a = work.back();
+      work.pop_back();
+      auto iter = grammar.find(a);
+      if (iter == grammar.end())
+        continue;
+      for (const auto &exp : iter->second) {
+        for (size_t i = exp.size(); i-- > 0;) {
+          if (nonterminals.find(exp[i]) == nonterminals.end())
+            break;
+          if (followAffected.insert(exp[i]).second)
+            work.push_back(exp[i]);
+        }
+      }
+    }
+    for (char b : followAffected) {
+      followSet[b].clear();
+      if (b == start)
+        followSet[b].push_back('#');
+    }
+    followFixpoint(nonterminals, terminals, grammar, firstSet, followSet,
+                   followAffected);
+
+    // 分析表中只有上述非终结符对应的行需要重新构造
+    rebuiltRows.clear();
+    for (char e : edited) {
+      if (nonterminals.find(e) != nonterminals.end())
+        rebuiltRows.insert(e);
+    }
+    rebuiltRows.insert(firstAffected.begin(), firstAffected.end());
+    rebuiltRows.insert(followAffected.begin(), followAffected.end());
+    for (char a : rebuiltRows) {
+      LL1Row(a, grammar.at(a), firstSet, followSet, terminals, list);
+    }
+    return true;
+  }
+
+  Grammar rawGrammar; // 消除左递归前的文法
+  Grammar grammar;    // 消除左递归后的文法
+  char start;         // 文法开始符
+  std::set<char> nonterminals;
+  std::set<char> terminals;
+  std::map<std::string, std::vector<char>> firstSet;
+  std::map<char, std::vector<char>> followSet;
+  std::map<char, std::map<char, std::string>> list;
+  std::set<char> rebuiltRows;
+  std::map<char, char> introduced; // 非终结符 -> 消除其左递归时引入的新非终结符
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+constexpr uint32_t noNode = UINT32_MAX; // 空结点下标
+
+// 语法树结点
+// 子结点与兄弟结点都用结点池中的32位下标表示(左孩子右兄弟)
+struct ParseNode {
+  char symbol;          // 文法符号, 空串为' '
+  uint32_t firstChild;  // 第一个子结点
+  uint32_t nextSibling; // 下一个兄弟结点
+  uint32_t textBegin;   // 叶子结点的词法单元在文本缓冲区中的起始位置
+  uint32_t textLength;  // 叶子结点的词法单元长度
+};
+
+// 语法树
+// 所有结点连续存放在结点池中, 词法单元的文本连续存放在文本缓冲区中
+// 建树时不为单个结点分配内存, clear()一次性释放全部结点并保留容量供下次复用
+class ParseTree {
+public:
+  // 从结点池中分配一个结点
+  uint32_t newNode(char symbol) {
+    nodes.push_back(ParseNode{symbol, noNode, noNode, 0, 0});
+    return static_cast<uint32_t>(nodes.size() - 1);
+  }
+
+  // 记录叶子结点对应的词法单元
+  void setText(uint32_t id, const std::string &value) {
+    nodes[id].textBegin = static_cast<uint32_t>(text.size());
+    nodes[id].textLength = static_cast<uint32_t>(value.size());
+    text += value;
+  }
+
+  std::string_view getText(uint32_t id) const {
+    return std::string_view(text).substr(nodes[id].textBegin,
+                                         nodes[id].textLength);
+  }
+
+  const ParseNode &operator[](uint32_t id) const { return nodes[id]; }
+  ParseNode &operator[](uint32_t id) { return nodes[id]; }
+
+  size_t size() const { return nodes.size(); }
+  bool empty() const { return nodes.empty(); }
+
+  void reserve(size_t count) { nodes.reserve(count); }
+
+  void clear() {
+    nodes.clear();
+    text.clear();
+    root = noNode;
+  }
+
+  uint32_t root = noNode; // 根结点
+
+private:
+  std::vector<ParseNode> nodes; // 结点池
+  std::string text;             // 文本缓冲区
+
+  friend void toAbstract(const ParseTree &cst, ParseTree &ast);
+};
+
+// 叶子结点是否为二元运算符(除括号外的标点符号)
+inline bool isOperatorLeaf(const ParseNode &node) {
+  return node.firstChild == noNode &&
+         std::ispunct(static_cast<unsigned char>(node.symbol)) &&
+         std::string_view("()[]{}").find(node.symbol) == std::string_view::npos;
+}
+
+// 左括号对应的右括号, 不是左括号时返回'\0'
+inline char closingBracket(char ch) {
+  switch (ch) {
+  case '(':
+    return ')';
+  case '[':
+    return ']';
+  case '{':
+    return '}';
+  default:
+    return '\0';
+  }
+}
+
+// 由具体语法树得到抽象语法树
+//  - 去掉空串结点, 只有一个子结点的结点直接由子结点替代
+//  - 括号包围的子树直接由括号内的子树替代
+//  - 消除左递归得到的尾部非终结符 A'->+BA'|ε 折叠为左结合的运算,
+//    运算符结点以左右运算对象为子结点, 如 a+b*c 得到 +(a, *(b, c))
+// 子结点总是在父结点之后分配, 因此倒序遍历结点池即可自底向上处理, 不需要递归
+inline void toAbstract(const ParseTree &cst, ParseTree &ast) {
+  ast.clear();
+  if (cst.empty())
+    return;
+  ast.reserve(cst.size());
+  ast.text = cst.text;
+  // cst结点对应的ast结点
+  // 尾部结点对应一串尚缺左运算对象的运算符结点, 记录第一个运算符,
+  // 运算符结点的第一个子结点暂存右运算对象, 后续运算符记录在nextOperator中
+  std::vector<uint32_t> mapped(cst.size(), noNode);
+  std::vector<bool> isTail(cst.size(), false);
+  std::vector<uint32_t> nextOperator(cst.size(), noNode);
+  // 以left为最左边的运算对象, 依次连接op开始的运算符串
+  auto fold = [&](uint32_t left, uint32_t op) {
+    for (; op != noNode; op = nextOperator[op]) {
+      uint32_t right = ast[op].firstChild;
+      ast[op].firstChild = left;
+      ast[left].nextSibling = right;
+      left = op;
+    }
+    return left;
+  };
+  // 左边没有运算对象的运算符串, 第一个运算符作为一元运算符
+  auto unary = [&](uint32_t op) { return fold(op, nextOperator[op]); };
+  std::vector<uint32_t> kids, children;
+  for (size_t i = cst.size(); i-- > 0;) {
+    const ParseNode &node = cst[i];
+    if (node.firstChild == noNode) {
+      // 叶子结点, 空串直接去掉
+      if (node.symbol != ' ') {
+        mapped[i] = ast.newNode(node.symbol);
+        ast[mapped[i]].textBegin = node.textBegin;
+        ast[mapped[i]].textLength = node.textLength;
+      }
+      continue;
+    }
+    kids.clear();
+    for (uint32_t c = node.firstChild; c != noNode; c = cst[c].nextSibling) {
+      if (mapped[c] != noNode)
+        kids.push_back(c);
+    }
+    // 尾部结点: 运算符, 运算对象, 以及可能存在的下一个尾部结点
+    if ((kids.size() == 2 || (kids.size() == 3 && isTail[kids[2]])) &&
+        !isTail[kids[0]] && !isTail[kids[1]] &&
+        isOperatorLeaf(ast[mapped[kids[0]]])) {
+      uint32_t op = mapped[kids[0]];
+      ast[op].firstChild = mapped[kids[1]];
+      if (kids.size() == 3)
+        nextOperator[op] = mapped[kids[2]];
+      mapped[i] = op;
+      isTail[i] = true;
+      continue;
+    }
+    // 运算对象与其后的尾部结点折叠为一个运算符结点
+    children.clear();
+    for (size_t k = 0; k < kids.size(); k++) {
+      uint32_t c = kids[k];
+      if (isTail[c])
+        children.push_back(unary(mapped[c]));
+      else if (k + 1 < kids.size() && isTail[kids[k + 1]])
+        children.push_back(fold(mapped[c], mapped[kids[++k]]));
+      else
+        children.push_back(mapped[c]);
+    }
+    if (children.size() == 3 && ast[children[0]].firstChild == noNode &&
+        ast[children[2]].firstChild == noNode &&
+        closingBracket(ast[children[0]].symbol) != '\0' &&
+        closingBracket(ast[children[0]].symbol) == ast[children[2]].symbol) {
+      // 括号只用于分组, 去掉括号
+      mapped[i] = children[1];
+    } else if (children.size() == 1) {
+      mapped[i] = children[0];
+    } else if (children.size() > 1) {
+      mapped[i] = ast.newNode(node.symbol);
+      ast[mapped[i]].firstChild = children[0];
+      for (size_t k = 0; k + 1 < children.size(); k++)
+        ast[children[k]].nextSibling = children[k + 1];
+    }
+  }
+  ast.root = isTail[cst.root] ? unary(mapped[cst.root]) : mapped[cst.root];
+}
+
+// 按缩进打印语法树
+inline void printTree(const ParseTree &tree) {
+  if (tree.root == noNode)
+    return;
+  std::vector<std::pair<uint32_t, size_t>> stack{{tree.root, 0}};
+  while (!stack.empty()) {
+    auto [id, depth] = stack.back();
+    stack.pop_back();
+    const ParseNode &node = tree[id];
+    std::cout << std::string(depth * 2, ' ')
+              << (node.symbol == ' ' ? "ε" : std::string{node.symbol});
+    if (node.textLength != 0)
+      std::cout << " '" << tree.getText(id) << "'";
+    std::cout << "\n";
+    // 子结点逆序入栈, 保证按从左到右的顺序打印
+    size_t mark = stack.size();
+    for (uint32_t c = node.firstChild; c != noNode; c = tree[c].nextSibling)
+      stack.emplace_back(c, depth + 1);
+    std::reverse(stack.begin() + mark, stack.end());
+  }
+}
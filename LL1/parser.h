@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../lexAnalyzer/lexer.h"
+#include "compressedTable.h"
+#include "grammar.h"
+#include "parseTree.h"
+#include "tokenQueue.h"
+
+// 连接词法分析线程与语法分析线程的词法单元队列
+using TokenQueue = SPSCQueue<Token, 256>;
+
+// 已完成词法分析的词法单元序列, 与TokenQueue一样按顺序取出词法单元
+struct TokenSpan {
+  const std::vector<Token> &tokens;
+  size_t pos = 0;
+
+  bool pop(Token &out) {
+    if (pos == tokens.size())
+      return false;
+    out = tokens[pos++];
+    return true;
+  }
+};
+
+// 分析过程使用的栈, 多次分析之间复用以避免重复分配内存
+struct ParseBuffers {
+  std::vector<char> analyzeStack;
+  std::vector<uint32_t> nodeStack;
+  size_t steps = 0;   // 最近一次分析的步数
+  size_t symbols = 0; // 最近一次分析读入的词法单元个数
+};
+
+// 将词法单元映射为文法中的终结符, 无法映射时返回'\0'
+inline char toTerminal(const Token &token) {
+  switch (token.type) {
+  case IDENTIFIER:
+  case CONSTANT:
+    return 'i'; // 标识符和常数都作为运算对象i
+  case OPERATOR:
+  case DELIMITER:
+    if (token.value.size() == 1)
+      return token.value[0];
+    return '\0';
+  default:
+    return '\0';
+  }
+}
+
+// 分析词法单元序列是否为文法所定义
+// source为TokenQueue或TokenSpan
+// tree不为空时在分析过程中同时构造具体语法树, trace不为空时打印分析过程
+// buffers不为空时使用其中的栈, 否则使用临时分配的栈
+template <typename Source,
+          typename = std::enable_if_t<!std::is_same_v<Source, std::string>>>
+bool LL1Analyze(const CompressedTable &table, Source &source,
+                ParseTree *tree = nullptr, std::ostream *trace = nullptr,
+                ParseBuffers *buffers = nullptr) {
+  ParseBuffers local;
+  if (!buffers)
+    buffers = &local;
+  // 初始化分析栈
+  std::vector<char> &analyzeStack = buffers->analyzeStack;
+  analyzeStack.clear();
+  analyzeStack.push_back('#');
+  analyzeStack.push_back(table.getStart());
+  // 与分析栈对应的语法树结点栈
+  std::vector<uint32_t> &nodeStack = buffers->nodeStack;
+  nodeStack.clear();
+  buffers->steps = 0;
+  buffers->symbols = 0;
+  if (tree) {
+    tree->clear();
+    tree->root = tree->newNode(table.getStart());
+    nodeStack.push_back(noNode);
+    nodeStack.push_back(tree->root);
+  }
+  // 读取下一个词法单元作为当前符号, 输入结束时当前符号为'#'
+  Token token{};
+  char topStr;
+  auto advance = [&]() {
+    if (source.pop(token)) {
+      topStr = toTerminal(token);
+      buffers->symbols++;
+    } else {
+      token = Token{DELIMITER, "#"};
+      topStr = '#';
+    }
+  };
+  advance();
+
+  // 打印分析过程
+  if (trace)
+    *trace << "步骤\t分析栈\t当前符号\t所用表达式\n";
+  int id = 1;
+  while (!analyzeStack.empty()) {
+    buffers->steps++;
+    if (trace) {
+      *trace << id++ << "\t";
+      for (size_t i = 0; i < analyzeStack.size(); i++) {
+        *trace << analyzeStack[i];
+      }
+      *trace << "\t" << token.value << "\t";
+    }
+
+    char topAnalyze = analyzeStack.back();
+    if (topAnalyze == topStr) {
+      // 终结符匹配
+      analyzeStack.pop_back();
+      if (tree) {
+        if (topStr != '#')
+          tree->setText(nodeStack.back(), token.value);
+        nodeStack.pop_back();
+      }
+      if (trace)
+        *trace << "\n";
+      if (topStr == '#')
+        break;
+      advance();
+    } else if (table.isNonterminal(topAnalyze)) {
+      // 非终结符处理
+      const std::string *cell = table.lookup(topAnalyze, topStr);
+      if (cell) {
+        analyzeStack.pop_back();
+        const std::string &production = *cell;
+        if (trace)
+          *trace << topAnalyze << "->" << production << "\n";
+        // 消除左递归后产生式中可能含有空串符号, 如 A->βA' 中β为空串,
+        // 空串符号不入栈, 只有产生式为空串时才作为一个叶子结点
+        if (tree) {
+          // 为产生式右部的每个符号建立子结点
+          uint32_t parent = nodeStack.back();
+          nodeStack.pop_back();
+          uint32_t prev = noNode;
+          size_t mark = nodeStack.size();
+          for (char ch : production) {
+            if (ch == ' ' && production != " ")
+              continue;
+            uint32_t child = tree->newNode(ch);
+            if (prev == noNode)
+              (*tree)[parent].firstChild = child;
+            else
+              (*tree)[prev].nextSibling = child;
+            prev = child;
+            if (ch != ' ')
+              nodeStack.push_back(child);
+          }
+          std::reverse(nodeStack.begin() + mark, nodeStack.end());
+        }
+        for (int i = production.size() - 1; i >= 0; --i) {
+          if (production[i] != ' ')
+            analyzeStack.push_back(production[i]);
+        }
+      } else {
+        // 无法找到对应的产生式
+        if (trace)
+          *trace << "\n";
+        return false;
+      }
+    } else {
+      // 终结符不匹配
+      if (trace)
+        *trace << "\n";
+      return false;
+    }
+  }
+
+  // 分析栈空且输入串读完, 说明匹配成功
+  return analyzeStack.empty() && topStr == '#';
+}
+
+// 分析源串是否为文法所定义
+// 词法分析在独立线程中运行, 词法单元经队列交给语法分析, 两者流水线并行
+inline bool LL1Analyze(const CompressedTable &table, const std::string &src,
+                       ParseTree *tree = nullptr, std::ostream *trace = nullptr,
+                       ParseBuffers *buffers = nullptr) {
+  TokenQueue queue;
+  std::thread lexer([&]() {
+    std::istringstream str(src);
+    analyzeStream(str, [&](Token token) {
+      // 语法分析已结束时置流为失败状态, 使词法分析立即停止
+      if (!queue.push(std::move(token)))
+        str.setstate(std::ios::failbit);
+    });
+    queue.close();
+  });
+  bool accepted = LL1Analyze(table, queue, tree, trace, buffers);
+  // 分析提前失败时剩余的输入不必再做词法分析
+  queue.cancel();
+  lexer.join();
+  return accepted;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+// 单生产者/单消费者的无锁环形队列
+// 词法分析线程push, 语法分析线程pop, 两端各自只写自己的下标
+// 消费者不再需要后续元素时调用cancel, 生产者据此提前结束
+template <typename T, size_t Capacity> class SPSCQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0, "容量必须是2的幂");
+
+public:
+  // 放入一个元素, 队列满时让出CPU等待消费者
+  // 消费者已取消时丢弃该元素并返回false
+  bool push(T value) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    while (tail - head_.load(std::memory_order_acquire) == Capacity) {
+      if (cancelled())
+        return false;
+      std::this_thread::yield();
+    }
+    if (cancelled())
+      return false;
+    buffer_[tail & (Capacity - 1)] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 生产者结束输入
+  void close() { closed_.store(true, std::memory_order_release); }
+
+  // 消费者放弃剩余的元素
+  void cancel() { cancelled_.store(true, std::memory_order_release); }
+
+  bool cancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+  // 取出一个元素, 队列空时等待生产者
+  // 队列已关闭且没有剩余元素时返回false
+  bool pop(T &out) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    while (head == tail_.load(std::memory_order_acquire)) {
+      if (closed_.load(std::memory_order_acquire)) {
+        // close前push的元素此时一定可见, 再检查一次
+        if (head == tail_.load(std::memory_order_acquire))
+          return false;
+        break;
+      }
+      std::this_thread::yield();
+    }
+    out = std::move(buffer_[head & (Capacity - 1)]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::array<T, Capacity> buffer_{};
+  // 两个下标分别位于不同缓存行, 避免生产者和消费者互相使缓存行失效
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+  alignas(64) std::atomic<bool> closed_{false};
+  std::atomic<bool> cancelled_{false};
+};
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <fstream>
+#include <istream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 词法单元的类型
+enum TokenType {
+  KEYWORD,    // 关键字
+  IDENTIFIER, // 标识符
+  OPERATOR,   // 操作符
+  CONSTANT,   // 常数
+  STRING,     // 字符串
+  DELIMITER,  // 分隔符
+};
+// 按照枚举值存储类型名称的数组
+inline const std::string tokenArr[]{"keyword",  "identifier", "operator",
+                                    "constant", "string",     "delimiter"};
+
+// 词法单元的表示
+struct Token {
+  TokenType type;
+  std::string value;
+};
+
+// 默认的关键字集合
+inline const std::set<std::string> keywords{
+    "void",  "char", "int",    "float",    "double",
+    "short", "long", "signed", "unsigned",
+		"struct", "union", "enum", "typedef", "sizeof",
+		"auto", "static", "register", "extern", "const", "volatile",
+		"return","continue","break","goto",
+		"if", "else", "switch", "case", "default",
+		"for", "do", "while"
+};
+
+inline bool isMatch(char expected, std::istream &str);  // 是否匹配提供的字符
+inline bool isDigit(char ch);                            // 是否匹配数字
+inline bool isAlpha(char ch);                            // 是否匹配字母下划线
+inline bool isAlphaNumeric(char ch);                     // 是否匹配字母下划线数字
+inline std::string getNum(std::istream &str);           // 获取常数
+inline std::string getString(std::istream &str);        // 获取字符串常量
+inline std::string getIdentifier(std::istream &str);    // 获取标字符或关键字
+inline bool analyzeFile(const std::string &input, std::vector<Token> &tokens,
+                        const std::set<std::string> &keywordSet = keywords); // 词法分析(处理文件)
+inline std::vector<Token> analyzeStr(const std::string &src,
+                                     const std::set<std::string> &keywordSet = keywords); // 词法分析(处理输入字符串)
+
+inline bool isMatch(char expected, std::istream &str) {
+  if (str.eof())
+    return false;
+  if (str.peek() == expected) {
+    str.get(); // 下一个字符匹配成功后跳过该字符
+    return true;
+  }
+  return false;
+}
+
+inline std::string getString(std::istream &str) {
+  std::string res{};
+  // 字符串字面值用""包围
+  while (str.peek() != '"' && !str.eof()) {
+    res += str.get();
+  }
+  // 跳过未读取到的"符号
+  str.get();
+  return res;
+}
+
+inline std::string getNum(std::istream &str) {
+  std::string num{};
+  str.unget();
+  // 读取所有数字字符
+  while (isDigit(str.peek()))
+    num += str.get();
+  // 浮点数处理
+  if (str.peek() == '.') {
+    char dot = str.get();
+    if (isDigit(str.peek())) {
+      num += dot;
+      while (isDigit(str.peek()))
+        num += str.get();
+    }
+  }
+  return num;
+}
+
+// 获取标识符或关键字
+// 标识符正则表达式[a-zA-Z_][a-zA-Z_0-9]*
+inline std::string getIdentifier(std::istream &str) {
+  std::string identifier{};
+  str.unget();
+  // 识别[a-zA-Z_0-9]*过程
+  while (isAlphaNumeric(str.peek())) {
+    identifier += str.get();
+  }
+  return identifier;
+}
+
+inline bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+inline bool isAlpha(char ch) {
+  return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_';
+}
+inline bool isAlphaNumeric(char ch) { return isAlpha(ch) || isDigit(ch); }
+
+// 词法分析(处理输入流)
+// 每识别出一个词法单元就交给emit处理, 调用方可以边扫描边消费词法单元
+// keywordSet为识别为关键字的标识符集合
+template <typename Emit>
+void analyzeStream(std::istream &str, Emit &&emit,
+                   const std::set<std::string> &keywordSet = keywords) {
+  char ch;
+  // 逐个处理输入的字符直到文件尾
+  while (str >> ch) {
+    switch (ch) {
+    case '{':
+      emit(Token{DELIMITER, "{"});
+      break;
+    case '}':
+      emit(Token{DELIMITER, "}"});
+      break;
+    case ',':
+      emit(Token{DELIMITER, ","});
+      break;
+    case ';':
+      emit(Token{DELIMITER, ";"});
+      break;
+    case '(':
+      emit(Token{DELIMITER, "("});
+      break;
+    case ')':
+      emit(Token{DELIMITER, ")"});
+      break;
+    case '+':
+      emit(Token{OPERATOR, "+"});
+      break;
+    case '-':
+      emit(Token{OPERATOR, "-"});
+      break;
+    case '*':
+      emit(Token{OPERATOR, "*"});
+      break;
+      // 对于操作符 = ! > <, 需要考虑后一个字符是否是 = 的情况
+      // 因为这代表 == != >= <= 操作符
+    case '=':
+      if (isMatch('=', str))
+        emit(Token{OPERATOR, "=="});
+      else
+        emit(Token{OPERATOR, "="});
+      break;
+    case '!':
+      if (isMatch('=', str))
+        emit(Token{OPERATOR, "!="});
+      else
+        emit(Token{OPERATOR, "!"});
+      break;
+    case '>':
+      if (isMatch('=', str))
+        emit(Token{OPERATOR, ">="});
+      else
+        emit(Token{OPERATOR, ">"});
+      break;
+    case '<':
+      if (isMatch('=', str))
+        emit(Token{OPERATOR, "<="});
+      else
+        emit(Token{OPERATOR, "<"});
+      break;
+      // 除法操作符'/'需要考虑是否是注释操作符'//'的情况
+    case '/':
+      if (isMatch('/', str)) {
+        while (str.peek() != '\n' && !str.eof()) // 跳过注释
+          str.get();
+      } else {
+        emit(Token{OPERATOR, "/"});
+      }
+    // 跳过空白
+    case ' ':
+    case '\t':
+    case '\r':
+    case '\n':
+      break;
+    case '"':
+      emit(Token{STRING, getString(str)});
+
+    default:
+      if (isDigit(ch)) { // 识别到数字
+        emit(Token{CONSTANT, getNum(str)});
+      } else if (isAlpha(ch)) { // 识别到字母下划线
+        std::string identifier = getIdentifier(str);
+        if (keywordSet.find(identifier) != keywordSet.end())
+          // 如果返回的字符串匹配到关键字
+          emit(Token{KEYWORD, identifier});
+        else
+          // 未匹配到关键字则说明是标识符
+          emit(Token{IDENTIFIER, identifier});
+      }
+      break;
+    }
+  }
+}
+
+// 词法分析(处理文件), 文件无法打开时返回false
+inline bool analyzeFile(const std::string &input, std::vector<Token> &tokens,
+                        const std::set<std::string> &keywordSet) {
+  std::ifstream str(input);
+  if (!str.is_open())
+    return false;
+  tokens.clear();
+  analyzeStream(
+      str, [&](Token token) { tokens.push_back(std::move(token)); },
+      keywordSet);
+  str.close();
+  return true;
+}
+
+// 词法分析(处理输入字符串)
+inline std::vector<Token> analyzeStr(const std::string &src,
+                                     const std::set<std::string> &keywordSet) {
+  std::istringstream str(src);
+  std::vector<Token> tokens;
+  analyzeStream(
+      str, [&](Token token) { tokens.push_back(std::move(token)); },
+      keywordSet);
+  return tokens;
+}
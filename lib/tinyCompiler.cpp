@@ -0,0 +1,144 @@
+#include "tinyCompiler.h"
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../LL1/grammar.h"
+
+const char *statusMessage(Status status) {
+  switch (status) {
+  case Status::OK:
+    return "ok";
+  case Status::FILE_OPEN_FAILED:
+    return "cannot open file";
+  case Status::INVALID_GRAMMAR:
+    return "invalid grammar";
+  case Status::INVALID_START:
+    return "start symbol is not a nonterminal";
+  case Status::LEFT_RECURSION:
+    return "grammar is left recursive";
+  case Status::NOT_LL1:
+    return "grammar is not LL(1)";
+  case Status::SYNTAX_ERROR:
+    return "syntax error";
+  }
+  return "unknown error";
+}
+
+// 同一非终结符的两个产生式的选择集相交时分析表存在冲突
+static bool
+hasConflict(const std::unordered_map<char, std::vector<std::string>> &grammar,
+            const std::map<std::string, std::vector<char>> &firstSet,
+            const std::map<char, std::vector<char>> &followSet) {
+  for (const auto &[A, exps] : grammar) {
+    std::set<char> selected;
+    for (const auto &alpha : exps) {
+      std::set<char> select;
+      for (char a : firstSet.at(alpha)) {
+        if (a == ' ') {
+          const auto &follow = followSet.at(A);
+          select.insert(follow.begin(), follow.end());
+        } else {
+          select.insert(a);
+        }
+      }
+      for (char a : select) {
+        if (!selected.insert(a).second)
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+Status compileGrammar(
+    const std::unordered_map<char, std::vector<std::string>> &grammar,
+    char start, std::shared_ptr<const CompiledGrammar> &out) {
+  if (grammar.empty())
+    return Status::INVALID_GRAMMAR;
+  for (const auto &[non, exps] : grammar) {
+    if (exps.empty())
+      return Status::INVALID_GRAMMAR;
+    for (const auto &exp : exps) {
+      if (exp.empty())
+        return Status::INVALID_GRAMMAR;
+    }
+  }
+  if (grammar.find(start) == grammar.end())
+    return Status::INVALID_START;
+
+  auto compiled = std::make_shared<CompiledGrammar>();
+  compiled->grammar = grammar;
+  compiled->start = start;
+  // 没有可用的字符作为消除左递归引入的新非终结符
+  if (!eliLeftRecursion(compiled->grammar))
+    return Status::INVALID_GRAMMAR;
+  std::tie(compiled->nonterminals, compiled->terminals) =
+      getSymbols(compiled->grammar);
+  // 有左递归时求first集不会结束
+  if (hasLeftRecursion(compiled->grammar, compiled->nonterminals))
+    return Status::LEFT_RECURSION;
+  compiled->firstSet = getFirstSet(compiled->nonterminals,
+                                   compiled->terminals, compiled->grammar);
+  compiled->followSet =
+      getFollowSet(compiled->nonterminals, compiled->terminals,
+                   compiled->grammar, compiled->firstSet, start);
+  if (hasConflict(compiled->grammar, compiled->firstSet, compiled->followSet))
+    return Status::NOT_LL1;
+  compiled->list = LL1(compiled->firstSet, compiled->followSet,
+                       compiled->terminals, compiled->grammar);
+  compiled->table = CompressedTable(compiled->list, start);
+  out = std::move(compiled);
+  return Status::OK;
+}
+
+Status compileGrammarFile(const std::string &path,
+                          std::shared_ptr<const CompiledGrammar> &out) {
+  std::unordered_map<char, std::vector<std::string>> grammar;
+  char start;
+  std::ifstream file(path);
+  if (!file.is_open())
+    return Status::FILE_OPEN_FAILED;
+  file.close();
+  if (!loadGrammar(path, grammar, start))
+    return Status::INVALID_GRAMMAR;
+  return compileGrammar(grammar, start, out);
+}
+
+Status tokenize(const LexerConfig &config, const std::string &src,
+                std::vector<Token> &tokens) {
+  std::istringstream str(src);
+  tokens.clear();
+  analyzeStream(
+      str, [&](Token token) { tokens.push_back(std::move(token)); },
+      config.keywords);
+  return Status::OK;
+}
+
+Status tokenizeFile(const LexerConfig &config, const std::string &path,
+                    std::vector<Token> &tokens) {
+  if (!analyzeFile(path, tokens, config.keywords))
+    return Status::FILE_OPEN_FAILED;
+  return Status::OK;
+}
+
+// 调用方通常已在自己的工作线程中处理请求, 这里不再为词法分析单独创建线程,
+// 而是先把词法单元写入workspace中复用的缓冲区再分析
+Status parse(const CompiledGrammar &grammar, const LexerConfig &config,
+             const std::string &src, ParseWorkspace &workspace,
+             bool buildTree) {
+  Status status = tokenize(config, src, workspace.tokens);
+  if (status != Status::OK)
+    return status;
+  TokenSpan span{workspace.tokens};
+  bool accepted =
+      LL1Analyze(grammar.table, span, buildTree ? &workspace.tree : nullptr,
+                 nullptr, &workspace.buffers);
+  return accepted ? Status::OK : Status::SYNTAX_ERROR;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// 词法分析器与LL1语法分析器的库接口
+// 不使用全局可变状态, 出错时返回错误码而不是退出进程:
+//  - LexerConfig与CompiledGrammar构造完成后只读, 可以在多个线程间共享
+//  - ParseWorkspace保存一次分析所需的缓冲区, 每个线程各自持有并反复使用
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../LL1/compressedTable.h"
+#include "../LL1/parseTree.h"
+#include "../LL1/parser.h"
+#include "../lexAnalyzer/lexer.h"
+
+// 错误码
+enum class Status {
+  OK,
+  FILE_OPEN_FAILED, // 文件无法打开
+  INVALID_GRAMMAR,  // 文法格式错误或为空
+  INVALID_START,    // 文法开始符不是非终结符
+  LEFT_RECURSION,   // 消除直接左递归后仍有左递归
+  NOT_LL1,          // 分析表中存在冲突, 文法不是LL1文法
+  SYNTAX_ERROR,     // 输入串不是文法所定义的句子
+};
+
+// 错误码对应的说明
+const char *statusMessage(Status status);
+
+// 词法分析配置
+struct LexerConfig {
+  std::set<std::string> keywords = ::keywords; // 关键字集合
+};
+
+// 编译后的文法: 消除左递归后的文法、first集、follow集和分析表
+struct CompiledGrammar {
+  std::unordered_map<char, std::vector<std::string>> grammar;
+  char start;
+  std::set<char> nonterminals;
+  std::set<char> terminals;
+  std::map<std::string, std::vector<char>> firstSet;
+  std::map<char, std::vector<char>> followSet;
+  std::map<char, std::map<char, std::string>> list;
+  CompressedTable table;
+};
+
+// 每个线程的分析缓冲区
+struct ParseWorkspace {
+  std::vector<Token> tokens; // 词法分析结果
+  ParseBuffers buffers;      // 分析栈
+  ParseTree tree;            // 语法树
+};
+
+// 编译文法
+Status compileGrammar(
+    const std::unordered_map<char, std::vector<std::string>> &grammar,
+    char start, std::shared_ptr<const CompiledGrammar> &out);
+
+// 从文件读取并编译文法, 文件格式见loadGrammar
+Status compileGrammarFile(const std::string &path,
+                          std::shared_ptr<const CompiledGrammar> &out);
+
+// 对源串做词法分析, 结果保存在tokens中
+Status tokenize(const LexerConfig &config, const std::string &src,
+                std::vector<Token> &tokens);
+
+// 对文件做词法分析, 结果保存在tokens中
+Status tokenizeFile(const LexerConfig &config, const std::string &path,
+                    std::vector<Token> &tokens);
+
+// 分析源串是否为文法所定义的句子
+// 词法单元和分析栈保存在workspace中, buildTree为true时语法树保存在workspace.tree中
+Status parse(const CompiledGrammar &grammar, const LexerConfig &config,
+             const std::string &src, ParseWorkspace &workspace,
+             bool buildTree = false);
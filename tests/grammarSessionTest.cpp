@@ -0,0 +1,228 @@
+// GrammarSession增量分析的正确性测试
+// 每次修改产生式后, 将会话中的first集、follow集和分析表与从头计算的结果比较
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../LL1/grammar.h"
+#include "../LL1/grammarSession.h"
+
+using Grammar = std::unordered_map<char, std::vector<std::string>>;
+
+static int failures = 0;
+
+#define CHECK(cond, what)                                                      \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": " << what << "\n";       \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+// 从头分析的结果
+struct Analysis {
+  std::map<std::string, std::vector<char>> firstSet;
+  std::map<char, std::vector<char>> followSet;
+  std::map<char, std::map<char, std::string>> list;
+  bool conflict = false; // 分析表中是否有冲突
+};
+
+static Analysis analyze(Grammar grammar, char start) {
+  Analysis result;
+  eliLeftRecursion(grammar);
+  auto [nonterminals, terminals] = getSymbols(grammar);
+  result.firstSet = getFirstSet(nonterminals, terminals, grammar);
+  result.followSet =
+      getFollowSet(nonterminals, terminals, grammar, result.firstSet, start);
+  result.list = LL1(result.firstSet, result.followSet, terminals, grammar);
+  // 同一非终结符的两个产生式选择集相交时, 表项取决于产生式的处理顺序
+  for (const auto &[A, exps] : grammar) {
+    std::set<char> selected;
+    for (const auto &alpha : exps) {
+      std::set<char> select;
+      for (char a : result.firstSet.at(alpha)) {
+        if (a == ' ')
+          select.insert(result.followSet.at(A).begin(),
+                        result.followSet.at(A).end());
+        else
+          select.insert(a);
+      }
+      for (char a : select)
+        result.conflict |= !selected.insert(a).second;
+    }
+  }
+  return result;
+}
+
+// 集合中元素的顺序取决于文法的遍历顺序, 只比较元素
+template <typename Key>
+static std::map<Key, std::set<char>>
+toSets(const std::map<Key, std::vector<char>> &sets) {
+  std::map<Key, std::set<char>> result;
+  for (const auto &[key, set] : sets)
+    result[key] = std::set<char>(set.begin(), set.end());
+  return result;
+}
+
+static void compare(const GrammarSession &session, const Grammar &grammar,
+                    char start, const std::string &step) {
+  Analysis expected = analyze(grammar, start);
+  CHECK(toSets(session.getFirstSet()) == toSets(expected.firstSet),
+        step << ": first集不一致");
+  CHECK(toSets(session.getFollowSet()) == toSets(expected.followSet),
+        step << ": follow集不一致");
+  if (!expected.conflict)
+    CHECK(session.getTable() == expected.list, step << ": 分析表不一致");
+}
+
+// 默认文法上的几类典型修改
+static void testEdits() {
+  Grammar grammar;
+  char start;
+  init(grammar, start);
+  GrammarSession session(grammar, start);
+  compare(session, grammar, start, "初始文法");
+
+  // 先定义尚未被引用的可空非终结符, 再引用它
+  CHECK(session.addProduction('G', " "), "G->ε被拒绝");
+  grammar['G'].push_back(" ");
+  compare(session, grammar, start, "增加G->ε");
+  CHECK(session.replaceProduction('F', "i", "iG"), "F->iG被拒绝");
+  grammar['F'] = {"(E)", "iG"};
+  compare(session, grammar, start, "F->i改为F->iG");
+  CHECK(session.addProduction('G', "[E]G"), "G->[E]G被拒绝");
+  grammar['G'].push_back("[E]G");
+  compare(session, grammar, start, "增加G->[E]G");
+
+  // 使已有非终结符可空
+  CHECK(session.addProduction('F', " "), "F->ε被拒绝");
+  grammar['F'].push_back(" ");
+  compare(session, grammar, start, "增加F->ε");
+  CHECK(session.removeProduction('F', " "), "删除F->ε被拒绝");
+  grammar['F'] = {"(E)", "iG"};
+  compare(session, grammar, start, "删除F->ε");
+
+  // 局部修改只重新构造受影响的分析表行
+  CHECK(session.addProduction('G', "+G"), "G->+G被拒绝");
+  grammar['G'].push_back("+G");
+  compare(session, grammar, start, "增加G->+G");
+  CHECK(session.getRebuiltRows().size() < session.getNonterminals().size(),
+        "增加G->+G后重新构造了全部" << session.getRebuiltRows().size()
+                                  << "行");
+  CHECK(session.removeProduction('G', "+G"), "删除G->+G被拒绝");
+  grammar['G'] = {" ", "[E]G"};
+  compare(session, grammar, start, "删除G->+G");
+
+  // 产生式用到消除T的左递归时引入的新非终结符'n'后, T应改用其他字符
+  CHECK(session.addProduction('F', "n"), "F->n被拒绝");
+  grammar['F'].push_back("n");
+  compare(session, grammar, start, "增加F->n");
+  CHECK(session.removeProduction('F', "n"), "删除F->n被拒绝");
+  grammar['F'] = {"(E)", "iG"};
+  compare(session, grammar, start, "删除F->n");
+
+  // 删除非终结符的全部产生式
+  CHECK(session.replaceProduction('F', "iG", "i"), "F->i被拒绝");
+  grammar['F'] = {"(E)", "i"};
+  CHECK(session.removeProduction('G', " "), "删除G->ε被拒绝");
+  CHECK(session.removeProduction('G', "[E]G"), "删除G->[E]G被拒绝");
+  grammar.erase('G');
+  compare(session, grammar, start, "删除G");
+}
+
+// 会引入间接左递归的修改应被拒绝, 且会话保持原状
+static void testLeftRecursion() {
+  Grammar grammar{{'S', {"Bc"}}, {'B', {"C"}}, {'C', {"d"}}};
+  GrammarSession session(grammar, 'S');
+  CHECK(!session.replaceProduction('C', "d", "Bd"), "C->Bd未被拒绝");
+  compare(session, grammar, 'S', "拒绝C->Bd");
+  CHECK(!session.addProduction('C', "Bd"), "增加C->Bd未被拒绝");
+  compare(session, grammar, 'S', "拒绝增加C->Bd");
+
+  // 经过可空的非终结符形成的左递归
+  CHECK(session.addProduction('D', " "), "D->ε被拒绝");
+  grammar['D'].push_back(" ");
+  CHECK(!session.addProduction('C', "DB"), "增加C->DB未被拒绝");
+  compare(session, grammar, 'S', "拒绝增加C->DB");
+
+  // 直接左递归会被消除, 不应拒绝
+  CHECK(session.addProduction('C', "Ce"), "C->Ce被拒绝");
+  grammar['C'].push_back("Ce");
+  compare(session, grammar, 'S', "增加C->Ce");
+}
+
+// 随机修改, 与从头分析的结果比较
+// 消除G的左递归时不能使用'G'+26, 即终结符'a'
+static void testRandomEdits() {
+  const std::string nonterminals = "SABCG";
+  const std::string symbols = "SABCGabcd";
+  std::mt19937 rng(1);
+  auto randomExp = [&]() {
+    std::string exp;
+    size_t length = rng() % 4;
+    for (size_t i = 0; i < length; i++)
+      exp += symbols[rng() % symbols.size()];
+    return exp.empty() ? std::string(" ") : exp;
+  };
+  for (int round = 0; round < 50; round++) {
+    Grammar grammar{{'S', {"Aa", "b"}}, {'A', {"c"}}};
+    GrammarSession session(grammar, 'S');
+    for (int step = 0; step < 40; step++) {
+      char non = nonterminals[rng() % nonterminals.size()];
+      Grammar edited = grammar;
+      auto &exps = edited[non];
+      bool accepted;
+      int kind = exps.empty() ? 0 : rng() % 3;
+      if (kind == 0) {
+        std::string exp = randomExp();
+        if (std::find(exps.begin(), exps.end(), exp) == exps.end())
+          exps.push_back(exp);
+        accepted = session.addProduction(non, exp);
+      } else {
+        size_t pos = rng() % exps.size();
+        std::string from = exps[pos];
+        if (kind == 1) {
+          exps.erase(exps.begin() + pos);
+          accepted = session.removeProduction(non, from);
+        } else {
+          std::string to = randomExp();
+          if (std::find(exps.begin(), exps.end(), to) != exps.end())
+            continue;
+          exps[pos] = to;
+          accepted = session.replaceProduction(non, from, to);
+        }
+      }
+      if (exps.empty())
+        edited.erase(non);
+      Grammar eliminated = edited;
+      eliLeftRecursion(eliminated);
+      bool recursive =
+          hasLeftRecursion(eliminated, getSymbols(eliminated).first);
+      CHECK(accepted == !recursive, "第" << round << "轮第" << step
+                                         << "步: 左递归判断错误");
+      if (accepted)
+        grammar = edited;
+      compare(session, grammar, 'S',
+              "第" + std::to_string(round) + "轮第" + std::to_string(step) +
+                  "步");
+    }
+  }
+}
+
+int main() {
+  testEdits();
+  testLeftRecursion();
+  testRandomEdits();
+  if (failures) {
+    std::cerr << failures << " 项检查失败\n";
+    return EXIT_FAILURE;
+  }
+  std::cout << "全部检查通过\n";
+  return EXIT_SUCCESS;
+}